@@ -34,8 +34,19 @@ class EvilEQApplication final : public juce::JUCEApplication
 
         void initialise(const juce::String& commandLine) override {
             // This method is where you should put your application's initialisation code..
-            juce::ignoreUnused(commandLine);
-            _mainWindow.reset(createWindow());
+            auto headless = evil::HeadlessAudioSettings::fromCommandLine(commandLine);
+            // Every slider in the editor draws through the sprite-caching look-and-feel.
+            juce::LookAndFeel::setDefaultLookAndFeel(&_lookAndFeel);
+            // Headless runs leave the saved device and plugin state alone.
+            auto* window = createWindow(headless ? nullptr : _appProperties.getUserSettings());
+            _mainWindow.reset(window);
+            if (headless)
+            {
+                headless->onInputFinished = [] { juce::JUCEApplication::quit(); };
+                const auto error = evil::HeadlessAudioIODeviceType::install(window->getPluginHolder()->deviceManager, *headless);
+                if (error.isNotEmpty())
+                    juce::Logger::writeToLog("Headless audio device failed to open: " + error);
+            }
             #if JUCE_STANDALONE_FILTER_WINDOW_USE_KIOSK_MODE
                 juce::Desktop::getInstance().setKioskModeComponent(_mainWindow.get(), false);
             #endif
@@ -44,6 +55,7 @@ class EvilEQApplication final : public juce::JUCEApplication
 
         void shutdown() override {
             _mainWindow = nullptr;
+            juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
             _appProperties.saveIfNeeded();
         };
 
@@ -69,7 +81,7 @@ class EvilEQApplication final : public juce::JUCEApplication
             juce::ignoreUnused (commandLine);
         };
     
-        juce::StandaloneFilterWindow* createWindow()
+        juce::StandaloneFilterWindow* createWindow(juce::PropertySet* settingsToUse)
         {
             #ifdef JucePlugin_PreferredChannelConfigurations
                 StandalonePluginHolder::PluginInOuts channels[] = { JucePlugin_PreferredChannelConfigurations };
@@ -77,7 +89,7 @@ class EvilEQApplication final : public juce::JUCEApplication
             return new juce::StandaloneFilterWindow(
                 getApplicationName(),
                 juce::LookAndFeel::getDefaultLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId),
-                _appProperties.getUserSettings(),
+                settingsToUse,
                 false, {}, nullptr
                 #ifdef JucePlugin_PreferredChannelConfigurations
                     , juce::Array<StandalonePluginHolder::PluginInOuts>(channels, juce::numElementsInArray(channels))
@@ -93,6 +105,7 @@ class EvilEQApplication final : public juce::JUCEApplication
     private:
       std::shared_ptr<juce::DocumentWindow> _mainWindow;
       juce::ApplicationProperties _appProperties;
+      EvilAudio_LookAndFeel _lookAndFeel;
 
 };
 
@@ -0,0 +1,186 @@
+#include <JuceHeader.h>
+#include <iostream>
+
+// Paints the equaliser editor into an offscreen image at several sizes and reports the
+// 50th, 90th and 99th percentile time of every layer: the per-frame display update, the
+// plot layers one at a time (drawn from scratch, without the caches and the render thread),
+// the child widgets, and a full paint of the editor as the host would do it. Noise is fed
+// through the processor until the analysers publish a new frame, and the display is then
+// updated the way the editor's vblank callback would, so every layer, the spectrogram and
+// the full paint (once the render thread has drawn the new layers) show real, changing spectra.
+//
+// Usage: EditorBenchmark [--frames N] [--scale S] [--default-look-and-feel]
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    struct Timings
+    {
+        juce::String name;
+        std::vector<double> microseconds;
+    };
+
+    double getPercentile(std::vector<double> values, double percentile)
+    {
+        if (values.empty())
+            return 0.0;
+
+        std::sort(values.begin(), values.end());
+        return values[juce::jmin(values.size() - 1, size_t(percentile * double(values.size())))];
+    }
+
+    template <typename Function>
+    void time(Timings& timings, Function&& function)
+    {
+        const auto start = juce::Time::getHighResolutionTicks();
+        function();
+        timings.microseconds.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e6);
+    }
+
+    void feedNoise(ParametricEqualiserProcessor& processor, juce::AudioBuffer<float>& buffer,
+                   juce::MidiBuffer& midi, juce::Random& random, int numBlocks)
+    {
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample(channel, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+            const juce::ScopedLock sl(processor.getCallbackLock());
+            processor.processBlock(buffer, midi);
+        }
+    }
+
+    // Feeds audio until the analysers have published some new frames, or gives up after a second.
+    void waitForAnalysers(ParametricEqualiserProcessor& processor, juce::AudioBuffer<float>& buffer,
+                          juce::MidiBuffer& midi, juce::Random& random, juce::uint64 numFrames)
+    {
+        const auto startGeneration = processor.getAnalyserGeneration();
+        const auto deadline = juce::Time::getMillisecondCounter() + 1000;
+
+        while (processor.getAnalyserGeneration() < startGeneration + numFrames && juce::Time::getMillisecondCounter() < deadline)
+        {
+            feedNoise(processor, buffer, midi, random, 2);
+            juce::Thread::sleep(1);
+        }
+    }
+
+    void paintChildren(juce::Component& editor, juce::Graphics& g)
+    {
+        for (auto* child : editor.getChildren())
+        {
+            if (! child->isVisible())
+                continue;
+
+            juce::Graphics::ScopedSaveState state(g);
+            g.reduceClipRegion(child->getBounds());
+            g.setOrigin(child->getPosition());
+            child->paintEntireComponent(g, true);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const auto numFrames = args.containsOption("--frames") ? juce::jmax(1, args.getValueForOption("--frames").getIntValue()) : 200;
+    const auto scale = args.containsOption("--scale") ? juce::jmax(0.5f, args.getValueForOption("--scale").getFloatValue()) : 1.0f;
+
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    // The sliders draw through the sprite cache unless the stock look-and-feel is asked for.
+    EvilAudio_LookAndFeel lookAndFeel;
+    if (! args.containsOption("--default-look-and-feel"))
+        juce::LookAndFeel::setDefaultLookAndFeel(&lookAndFeel);
+
+    {
+        ParametricEqualiserProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+
+        std::unique_ptr<juce::AudioProcessorEditor> editorHolder(processor.createEditor());
+        auto* editor = dynamic_cast<ParametricEqualiserEditor*>(editorHolder.get());
+        if (editor == nullptr)
+        {
+            std::cerr << "The processor did not create a ParametricEqualiserEditor\n";
+            return 1;
+        }
+
+        // The spectrogram only collects rows while it is switched on.
+        editor->setSpectrogramVisible(true);
+        waitForAnalysers(processor, buffer, midi, random, 8);
+
+        std::cout << "Look-and-feel: " << (args.containsOption("--default-look-and-feel") ? "default" : "EvilAudio") << ", "
+                  << numFrames << " frames, scale " << scale << "\n\n";
+
+        std::cout << juce::String("size").paddedRight(' ', 12)
+                  << juce::String("layer").paddedRight(' ', 14)
+                  << juce::String("p50 us").paddedLeft(' ', 10)
+                  << juce::String("p90 us").paddedLeft(' ', 10)
+                  << juce::String("p99 us").paddedLeft(' ', 10) << "\n";
+
+        using Layer = ParametricEqualiserEditor::Layer;
+        const std::pair<Layer, const char*> layers[] = {
+            { Layer::background, "background" },
+            { Layer::spectrogram, "spectrogram" },
+            { Layer::analyser, "analyser" },
+            { Layer::responses, "responses" },
+            { Layer::overlay, "overlay" },
+        };
+
+        // From the smallest size the editor allows to the largest.
+        for (auto size : { juce::Point<int>(800, 450), juce::Point<int>(1280, 720),
+                           juce::Point<int>(1920, 1080), juce::Point<int>(2990, 1800) })
+        {
+            editor->setSize(size.x, size.y);
+
+            juce::Image image(juce::Image::ARGB, juce::roundToInt(size.x * scale), juce::roundToInt(size.y * scale), true);
+            juce::Graphics g(image);
+            g.addTransform(juce::AffineTransform::scale(scale));
+
+            std::vector<Timings> timings;
+            timings.push_back({ "update", {} });
+            for (const auto& layer : layers)
+                timings.push_back({ layer.second, {} });
+            timings.push_back({ "widgets", {} });
+            timings.push_back({ "full paint", {} });
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                // A new analyser frame every frame, picked up as the vblank callback would.
+                waitForAnalysers(processor, buffer, midi, random, 1);
+                time(timings[0], [&] { editor->updateDisplay(); });
+
+                for (size_t i = 0; i < std::size(layers); ++i)
+                    time(timings[i + 1], [&] { editor->paintLayer(g, layers[i].first); });
+
+                time(timings[std::size(layers) + 1], [&] { paintChildren(*editor, g); });
+
+                // The full paint blits what the render thread drew for this update.
+                if (! editor->waitForPlotRenderer(1000))
+                    std::cerr << "The plot renderer did not finish a frame within a second\n";
+                time(timings[std::size(layers) + 2], [&] { editor->paintEntireComponent(g, true); });
+            }
+
+            for (const auto& layer : timings)
+                std::cout << (juce::String(size.x) + "x" + juce::String(size.y)).paddedRight(' ', 12)
+                          << layer.name.paddedRight(' ', 14)
+                          << juce::String(getPercentile(layer.microseconds, 0.5), 0).paddedLeft(' ', 10)
+                          << juce::String(getPercentile(layer.microseconds, 0.9), 0).paddedLeft(' ', 10)
+                          << juce::String(getPercentile(layer.microseconds, 0.99), 0).paddedLeft(' ', 10) << "\n";
+        }
+
+        editorHolder.reset();
+        processor.releaseResources();
+    }
+
+    juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
+    return 0;
+}
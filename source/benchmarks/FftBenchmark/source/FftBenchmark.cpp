@@ -0,0 +1,106 @@
+#include <JuceHeader.h>
+#include <iostream>
+
+// Times the FFT backends the analysers can use, for every size the analyser offers plus a
+// few smaller ones. Each measurement is the median of several batches, so a stray context
+// switch doesn't skew the result.
+//
+// Usage: FftBenchmark [--min-order N] [--max-order N] [--batches N]
+
+namespace
+{
+    struct Result
+    {
+        double nanosecondsPerTransform = 0.0;
+        double maxDifference = 0.0;
+    };
+
+    Result measure(FftBackend& backend, const std::vector<float>& input,
+                   const std::vector<float>& reference, int numBatches)
+    {
+        const auto size = backend.getSize();
+        std::vector<float> magnitudes(size_t(size / 2));
+
+        // Aim for roughly 20 ms per batch whatever the size.
+        const auto transformsPerBatch = juce::jmax(4, (1 << 21) / size);
+
+        for (int i = 0; i < transformsPerBatch; ++i)
+            backend.performMagnitudes(input.data(), magnitudes.data());
+
+        std::vector<double> batches;
+        for (int batch = 0; batch < numBatches; ++batch)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < transformsPerBatch; ++i)
+                backend.performMagnitudes(input.data(), magnitudes.data());
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            batches.push_back(seconds * 1.0e9 / transformsPerBatch);
+        }
+
+        std::sort(batches.begin(), batches.end());
+
+        Result result;
+        result.nanosecondsPerTransform = batches[batches.size() / 2];
+        for (size_t i = 0; i < magnitudes.size(); ++i)
+            result.maxDifference = juce::jmax(result.maxDifference, double(std::abs(magnitudes[i] - reference[i])));
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    const auto minOrder = args.containsOption("--min-order") ? args.getValueForOption("--min-order").getIntValue() : 8;
+    const auto maxOrder = args.containsOption("--max-order") ? args.getValueForOption("--max-order").getIntValue() : 15;
+    const auto numBatches = args.containsOption("--batches") ? juce::jmax(1, args.getValueForOption("--batches").getIntValue()) : 9;
+
+    std::cout << "juce::dsp::FFT uses a native engine: " << (FftBackend::isJuceNative() ? "yes" : "no") << "\n"
+              << "Preferred backend: " << FftBackend::create(minOrder)->getName() << "\n\n";
+
+    std::cout << juce::String("size").paddedLeft(' ', 7) << "  "
+              << juce::String("backend").paddedRight(' ', 18)
+              << juce::String("ns/fft").paddedLeft(' ', 12)
+              << juce::String("MFLOPS").paddedLeft(' ', 10)
+              << juce::String("speed-up").paddedLeft(' ', 10)
+              << juce::String("max diff").paddedLeft(' ', 12) << "\n";
+
+    juce::Random random(1);
+
+    for (int order = minOrder; order <= maxOrder; ++order)
+    {
+        const auto size = 1 << order;
+
+        std::vector<float> input(size_t(size));
+        for (auto& sample : input)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+
+        // JUCE's output is the reference the other backends are checked against.
+        auto juceBackend = FftBackend::create(order, FftBackend::Type::juce);
+        std::vector<float> reference(size_t(size / 2));
+        juceBackend->performMagnitudes(input.data(), reference.data());
+
+        double juceTime = 0.0;
+
+        for (auto type : { FftBackend::Type::juce, FftBackend::Type::builtIn })
+        {
+            auto backend = FftBackend::create(order, type);
+            const auto result = measure(*backend, input, reference, numBatches);
+
+            if (type == FftBackend::Type::juce)
+                juceTime = result.nanosecondsPerTransform;
+
+            // The conventional 2.5 N log2 N flop count of a real FFT.
+            const auto mflops = 2.5 * size * order / result.nanosecondsPerTransform * 1.0e3;
+
+            std::cout << juce::String(size).paddedLeft(' ', 7) << "  "
+                      << backend->getName().paddedRight(' ', 18)
+                      << juce::String(result.nanosecondsPerTransform, 0).paddedLeft(' ', 12)
+                      << juce::String(mflops, 0).paddedLeft(' ', 10)
+                      << (juce::String(juceTime / result.nanosecondsPerTransform, 2) + "x").paddedLeft(' ', 10)
+                      << juce::String(result.maxDifference, 6).paddedLeft(' ', 12) << "\n";
+        }
+    }
+
+    return 0;
+}
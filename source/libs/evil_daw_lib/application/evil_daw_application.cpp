@@ -1,4 +1,5 @@
 #include <juce_core/juce_core.h>
+#include <evilaudio_audio_devices/evilaudio_audio_devices.h>
 
 #include "evil_daw_application.h"
 #include "windows/main/evil_daw_main_window.h"
@@ -72,14 +73,20 @@ namespace evil
      */
     void EvilDAWApplication::initialise(const juce::String& commandLine)
     {
-        juce::ignoreUnused(commandLine);
-
-
         initialiseApplicatiomSettings();
         initialiseLogger("evil_daw_log");
         initialiseCommandManager();
         initialiseDeviceManager();
 
+        // --headless swaps the sound card for a test signal or WAV files (see HeadlessAudioSettings).
+        if (auto headless = evil::HeadlessAudioSettings::fromCommandLine(commandLine))
+        {
+            headless->onInputFinished = [] { juce::JUCEApplication::quit(); };
+            const auto error = evil::HeadlessAudioIODeviceType::install(*_audioDeviceManager, *headless);
+            if (error.isNotEmpty())
+                juce::Logger::writeToLog("Headless audio device failed to open: " + error);
+        }
+
         // Do further initialisation in a moment 
         // when the message loop has started
         triggerAsyncUpdate();
@@ -2,21 +2,162 @@
 
 #include <JuceHeader.h>
 
-class LiveScrollingAudioVisualiser final : public juce::AudioVisualiserComponent,
+/**
+ *  Scrolling input monitor for any number of channels, zoomable from milliseconds to
+ *  an hour and a half.
+ *
+ *  The audio callback reduces every 16 samples of each input channel to a min/max/RMS
+ *  summary and pushes them through a lock-free FIFO; it never blocks or allocates. On the
+ *  message thread the summaries are folded into a pyramid in which every level halves the
+ *  resolution of the one below, each level keeping the same number of entries. Drawing
+ *  picks the level with one or two entries per pixel, so it costs the same at any zoom.
+ *
+ *  Use the mouse wheel to zoom.
+ */
+class LiveScrollingAudioVisualiser final : public juce::Component,
     public juce::AudioIODeviceCallback
 {
 
 public:
+    /** Samples reduced into one summary by the audio callback. */
+    static constexpr int samplesPerSummary = 16;
+    /** Channels beyond this are not shown. */
+    static constexpr int maxChannels = 16;
+    /** Levels in the pyramid; the top one holds summaries of 16 * 2^13 samples. */
+    static constexpr int numLevels = 14;
+    /** Summaries kept in every level. Views wider than half this may use a coarser level. */
+    static constexpr int levelCapacity = 2048;
+    /** Summaries the FIFO holds per channel, about 2.7 seconds at 48 kHz. */
+    static constexpr int fifoCapacity = 8192;
+
     LiveScrollingAudioVisualiser()
-        : juce::AudioVisualiserComponent(1) // Mono display
     {
-        ///setNumChannels(2); // Stereo display
-        setColours(juce::Colours::black, juce::Colours::green);
-        setRepaintRate(60); // 60 Hz repaint rate
+        setOpaque(true);
+        _fifoData.resize(size_t(fifoCapacity * maxChannels));
+        for (auto& level : _levels)
+            level.entries.resize(size_t(levelCapacity * maxChannels));
     }
 
     ~LiveScrollingAudioVisualiser() override = default;
 
+    /** Sets the time shown across the width, clamped to what the pyramid can show. */
+    void setVisibleSeconds(double seconds)
+    {
+        _visibleSeconds = juce::jlimit(0.005, 5400.0, seconds);
+        repaint();
+    }
+
+    double getVisibleSeconds() const noexcept { return _visibleSeconds; }
+
+    /** Returns how many summaries were dropped because the message thread fell behind. */
+    juce::uint64 getDroppedSummaryCount() const noexcept { return _droppedSummaries; }
+
+    void paint(juce::Graphics& g) override
+    {
+        EVILAUDIO_PROFILE_PAINT(*this);
+        g.fillAll(juce::Colours::black);
+
+        const auto numChannels = juce::jmax(1, _displayChannels);
+        const auto bounds = getLocalBounds();
+        const auto width = bounds.getWidth();
+        if (width <= 0 || _levels[0].written == 0)
+            return;
+
+        // The finest level that still has at least one summary per pixel, or level 0 when
+        // zoomed in further than that. A wide view can need more summaries than a level
+        // keeps, so go coarser until the whole width fits in the ring, and stretch each
+        // summary over several pixels rather than leave the left of the view empty.
+        const auto samplesPerPixel = _visibleSeconds * _sampleRate / width;
+        auto level = 0;
+        while (level + 1 < numLevels && double(samplesPerSummary << (level + 1)) <= samplesPerPixel)
+            ++level;
+        while (level + 1 < numLevels && width * samplesPerPixel / double(samplesPerSummary << level) > levelCapacity)
+            ++level;
+
+        const auto& source = _levels[size_t(level)];
+        const auto summariesPerPixel = samplesPerPixel / double(samplesPerSummary << level);
+        const auto oldest = source.written > juce::uint64(levelCapacity) ? source.written - juce::uint64(levelCapacity) : juce::uint64(0);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto lane = bounds.withTrimmedTop(bounds.getHeight() * channel / numChannels)
+                              .withHeight(bounds.getHeight() / numChannels).toFloat().reduced(0.0f, 1.0f);
+            const auto toY = [lane](float value)
+            {
+                return juce::jmap(juce::jlimit(-1.0f, 1.0f, value), -1.0f, 1.0f, lane.getBottom(), lane.getY());
+            };
+
+            _peakPath.clear();
+            _rmsPath.clear();
+            _peakPath.preallocateSpace(width * 6 + 8);
+            _rmsPath.preallocateSpace(width * 6 + 8);
+
+            // Newest at the right: pixel x covers the summaries between its two edges.
+            _columns.clear();
+            for (int x = 0; x < width; ++x)
+            {
+                const auto newest = double(source.written) - (width - 1 - x) * summariesPerPixel;
+                const auto end = juce::uint64(juce::jmax(0.0, newest));
+                const auto begin = juce::uint64(juce::jmax(0.0, newest - summariesPerPixel));
+                if (end <= oldest)
+                    continue;
+
+                Summary summary;
+                auto meanSquare = 0.0f;
+                auto count = 0;
+                for (auto index = juce::jmax(begin, oldest); index < juce::jmax(end, begin + 1) && index < source.written; ++index, ++count)
+                {
+                    const auto& entry = source.entries[size_t((index % levelCapacity) * maxChannels + size_t(channel))];
+                    summary = merge(summary, entry);
+                    meanSquare += entry.meanSquare;
+                }
+
+                if (count == 0)
+                    continue;
+
+                _columns.push_back({ float(bounds.getX() + x) + 0.5f, summary.min, summary.max, std::sqrt(meanSquare / float(count)) });
+            }
+
+            if (_columns.empty())
+                continue;
+
+            // An envelope along the maxima and back along the minima, for the peaks and the RMS.
+            _peakPath.startNewSubPath(_columns.front().x, toY(_columns.front().max));
+            _rmsPath.startNewSubPath(_columns.front().x, toY(_columns.front().rms));
+            for (const auto& column : _columns)
+            {
+                _peakPath.lineTo(column.x, toY(column.max));
+                _rmsPath.lineTo(column.x, toY(column.rms));
+            }
+            for (auto column = _columns.rbegin(); column != _columns.rend(); ++column)
+            {
+                _peakPath.lineTo(column->x, toY(column->min));
+                _rmsPath.lineTo(column->x, toY(-column->rms));
+            }
+            _peakPath.closeSubPath();
+            _rmsPath.closeSubPath();
+
+            g.setColour(juce::Colours::green.withAlpha(0.6f));
+            g.fillPath(_peakPath);
+            g.setColour(juce::Colours::lightgreen);
+            g.fillPath(_rmsPath);
+
+            g.setColour(juce::Colours::white.withAlpha(0.15f));
+            g.drawHorizontalLine(juce::roundToInt(lane.getCentreY()), lane.getX(), lane.getRight());
+        }
+
+        g.setColour(juce::Colours::silver);
+        g.setFont(11.0f);
+        g.drawText(_visibleSeconds < 1.0 ? juce::String(_visibleSeconds * 1000.0, 0) + " ms"
+                                         : juce::String(_visibleSeconds, _visibleSeconds < 10.0 ? 1 : 0) + " s",
+                   bounds.reduced(4, 2), juce::Justification::topLeft, false);
+    }
+
+    void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override
+    {
+        setVisibleSeconds(_visibleSeconds * std::pow(2.0, -wheel.deltaY * 4.0));
+    }
+
     // AudioIODeviceCallback implementation
     void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
         int numInputChannels,
@@ -25,25 +166,185 @@ public:
         int numSamples,
         const juce::AudioIODeviceCallbackContext& context) override
     {
-        if (numInputChannels > 0 && inputChannelData[0] != nullptr)
-        {
-            pushBuffer(inputChannelData, 1, numSamples);
-        }
-        // Clear output buffers to avoid noise
-        for (int i = 0; i < numOutputChannels; ++i)
+        juce::ignoreUnused(context);
+        const auto numChannels = juce::jmin(numInputChannels, maxChannels);
+        _numChannels.store(numChannels, std::memory_order_relaxed);
+
+        for (int offset = 0; offset < numSamples;)
         {
-            if (outputChannelData[i] != nullptr)
-                juce::FloatVectorOperations::clear(outputChannelData[i], numSamples);
+            const auto count = juce::jmin(numSamples - offset, samplesPerSummary - _pendingSamples);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto& pending = _pending[size_t(channel)];
+                if (const auto* input = inputChannelData[channel])
+                {
+                    const auto range = juce::FloatVectorOperations::findMinAndMax(input + offset, count);
+                    pending.min = juce::jmin(pending.min, range.getStart());
+                    pending.max = juce::jmax(pending.max, range.getEnd());
+                    for (int i = 0; i < count; ++i)
+                        pending.meanSquare += input[offset + i] * input[offset + i];
+                }
+                else
+                {
+                    pending.min = juce::jmin(pending.min, 0.0f);
+                    pending.max = juce::jmax(pending.max, 0.0f);
+                }
+            }
+
+            offset += count;
+            _pendingSamples += count;
+            if (_pendingSamples == samplesPerSummary)
+                pushPendingSummary(numChannels);
         }
+
+        // Only reads its inputs; register it as an input tap of an evil::AudioCallbackMultiplexer.
+        juce::ignoreUnused(outputChannelData, numOutputChannels);
     }
 
     void audioDeviceAboutToStart(juce::AudioIODevice* device) override
     {
-        // Prepare for audio processing if needed
+        _pendingSamples = 0;
+        _pending.fill({});
+        if (device != nullptr)
+            _deviceSampleRate.store(device->getCurrentSampleRate());
     }
-    
+
     void audioDeviceStopped() override
     {
         // Clean up resources if needed
     }
-};
\ No newline at end of file
+
+private:
+    struct Summary
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        /** Sum of squares while accumulating, mean of squares once complete. */
+        float meanSquare = 0.0f;
+    };
+
+    static Summary merge(const Summary& a, const Summary& b) noexcept
+    {
+        if (a.max < a.min)
+            return b;
+
+        return { juce::jmin(a.min, b.min), juce::jmax(a.max, b.max), 0.5f * (a.meanSquare + b.meanSquare) };
+    }
+
+    struct Level
+    {
+        /** levelCapacity rows of maxChannels summaries, used as a ring. */
+        std::vector<Summary> entries;
+        /** Summaries ever added; the newest is at (written - 1) % levelCapacity. */
+        juce::uint64 written = 0;
+        /** The first of a pair waiting for its partner before it goes up a level. */
+        std::array<Summary, maxChannels> half;
+        bool hasHalf = false;
+    };
+
+    struct Column
+    {
+        float x, min, max, rms;
+    };
+
+    /** Audio thread: hands the finished summary to the message thread, or drops it if full. */
+    void pushPendingSummary(int numChannels)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            _pending[size_t(channel)].meanSquare /= float(samplesPerSummary);
+
+        if (_fifo.getFreeSpace() > 0)
+        {
+            const auto scope = _fifo.write(1);
+            std::copy(_pending.begin(), _pending.end(), _fifoData.begin() + scope.startIndex1 * maxChannels);
+        }
+        else
+        {
+            ++_droppedSummaries;
+        }
+
+        _pending.fill({});
+        _pendingSamples = 0;
+    }
+
+    /** Message thread: adds a row of summaries to a level, and every second pair to the next. */
+    void addToLevel(int levelIndex, const Summary* row)
+    {
+        for (;;)
+        {
+            auto& level = _levels[size_t(levelIndex)];
+            std::copy(row, row + maxChannels, level.entries.begin() + size_t((level.written % levelCapacity) * maxChannels));
+            ++level.written;
+
+            if (levelIndex + 1 >= numLevels)
+                return;
+
+            if (! level.hasHalf)
+            {
+                std::copy(row, row + maxChannels, level.half.begin());
+                level.hasHalf = true;
+                return;
+            }
+
+            for (int channel = 0; channel < maxChannels; ++channel)
+                _merged[size_t(channel)] = merge(level.half[size_t(channel)], row[channel]);
+
+            level.hasHalf = false;
+            row = _merged.data();
+            ++levelIndex;
+        }
+    }
+
+    /** Message thread, once per display frame: drains the FIFO into the pyramid. */
+    void update()
+    {
+        const auto numChannels = _numChannels.load(std::memory_order_relaxed);
+        const auto sampleRate = _deviceSampleRate.load();
+
+        // A different device layout starts the history again.
+        if (numChannels != _displayChannels || sampleRate != _sampleRate)
+        {
+            _displayChannels = numChannels;
+            _sampleRate = sampleRate;
+            for (auto& level : _levels)
+            {
+                level.written = 0;
+                level.hasHalf = false;
+            }
+        }
+
+        const auto ready = _fifo.getNumReady();
+        if (ready == 0)
+            return;
+
+        const auto scope = _fifo.read(ready);
+        scope.forEach([this](int index) { addToLevel(0, _fifoData.data() + size_t(index * maxChannels)); });
+        repaint();
+    }
+
+    double _visibleSeconds = 5.0;
+    double _sampleRate = 48000.0;
+    int _displayChannels = 0;
+
+    std::atomic<int> _numChannels{ 0 };
+    std::atomic<double> _deviceSampleRate{ 48000.0 };
+    std::atomic<juce::uint64> _droppedSummaries{ 0 };
+
+    /** Audio thread only: the summary being accumulated. */
+    std::array<Summary, maxChannels> _pending;
+    int _pendingSamples = 0;
+
+    juce::AbstractFifo _fifo{ fifoCapacity };
+    std::vector<Summary> _fifoData;
+
+    /** Message thread only. */
+    std::array<Level, numLevels> _levels;
+    std::array<Summary, maxChannels> _merged;
+    std::vector<Column> _columns;
+    juce::Path _peakPath, _rmsPath;
+
+    juce::VBlankAttachment _vBlankAttachment{ this, [this] { update(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LiveScrollingAudioVisualiser)
+};
@@ -71,12 +71,20 @@ public:
         addAndMakeVisible(_parametricEqualizerEditor.get());
 
         _liveScrollingAudioVisualiser.reset(new LiveScrollingAudioVisualiser());
-        _audioDeviceManager->addAudioCallback(_liveScrollingAudioVisualiser.get());
         addAndMakeVisible(_liveScrollingAudioVisualiser.get());
 
+#if EVILAUDIO_PAINT_PROFILING
+        addAndMakeVisible(_paintProfilerOverlay);
+#endif
+
         _audioProcessorPlayer.reset(new juce::AudioProcessorPlayer());
         _audioProcessorPlayer->setProcessor(_audioProcessor.get());
-        _audioDeviceManager->addAudioCallback(_audioProcessorPlayer.get());
+
+        // One device callback runs everything in a fixed order: the monitor taps the
+        // inputs, then the equaliser writes the outputs.
+        _audioCallbacks.addInputTap(_liveScrollingAudioVisualiser.get());
+        _audioCallbacks.addProcessor(_audioProcessorPlayer.get());
+        _audioDeviceManager->addAudioCallback(&_audioCallbacks);
 
         // Setup the application properties storage.
         juce::PropertiesFile::Options options;
@@ -178,8 +186,9 @@ public:
         _commandManager.setFirstCommandTarget(nullptr);
         _menuBarComponent->setModel(nullptr);
         
-        _audioDeviceManager->removeAudioCallback(_audioProcessorPlayer.get());
-        _audioDeviceManager->removeAudioCallback(_liveScrollingAudioVisualiser.get());
+        _audioDeviceManager->removeAudioCallback(&_audioCallbacks);
+        _audioCallbacks.removeCallback(_audioProcessorPlayer.get());
+        _audioCallbacks.removeCallback(_liveScrollingAudioVisualiser.get());
 
         _audioProcessorPlayer = nullptr;
 
@@ -200,6 +209,7 @@ public:
      * @param graphics Graphics context used for drawing.
      */
     void paint(juce::Graphics& graphics) override {
+        EVILAUDIO_PROFILE_PAINT(*this);
         // (Our component is opaque, so we must completely fill 
         // the background with a solid colour)
         graphics.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
@@ -211,6 +221,7 @@ public:
      * Use this to lay out child components and respond to size changes.
      */
     void resized() override {
+        EVILAUDIO_PROFILE_LAYOUT(*this);
         // This is called when the MainComponent is resized.
         // If you add any child components, this is where you should
         // update their positions.
@@ -219,9 +230,12 @@ public:
             _menuBarComponent->setBounds(bounds.removeFromTop(juce::LookAndFeel::getDefaultLookAndFeel()
                 .getDefaultMenuBarHeight()));
 
-            _liveScrollingAudioVisualiser->setBounds(bounds.removeFromBottom(32));
+            _liveScrollingAudioVisualiser->setBounds(bounds.removeFromBottom(96));
             _parametricEqualizerEditor->setBounds(bounds);
         }
+#if EVILAUDIO_PAINT_PROFILING
+        _paintProfilerOverlay.setTopLeftPosition(8, 8);
+#endif
     };
 
     /**
@@ -443,6 +457,14 @@ private:
 
     std::unique_ptr<juce::AudioProcessorPlayer> _audioProcessorPlayer;
 
+    /**
+     * @brief The single callback registered with the device manager.
+     *
+     * Runs the input monitor and the processor player in a defined order on the
+     * device's own buffers.
+     */
+    evil::AudioCallbackMultiplexer _audioCallbacks;
+
     /**
     * @brief The menu bar component shown at the top of the application window.
     *
@@ -467,6 +489,11 @@ private:
         */
     juce::Component::SafePointer<juce::DialogWindow> _dialogWindow;
 
+#if EVILAUDIO_PAINT_PROFILING
+    /** Live paint timings of the instrumented components in the window. */
+    EvilAudio_PaintProfilerOverlay _paintProfilerOverlay;
+#endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainWindowContent)
 
 };
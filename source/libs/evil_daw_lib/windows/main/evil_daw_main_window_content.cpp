@@ -18,6 +18,10 @@ namespace evil
         //_mainWindowMenu.reset(new MainWindowMenuBar(this));
         //addAndMakeVisible(_mainWindowMenu.get());
     
+#if EVILAUDIO_PAINT_PROFILING
+        addAndMakeVisible(_paintProfilerOverlay);
+#endif
+
         setWantsKeyboardFocus(true);
         setOpaque(true);
         setSize(800, 400);
@@ -25,6 +29,7 @@ namespace evil
     };
 
     void EvilDAWMainWindowContent::EvilDAWMainWindowContent::paint(juce::Graphics& graphics) {
+        EVILAUDIO_PROFILE_PAINT(*this);
         // (Our component is opaque, so we must completely fill 
         // the background with a solid colour)
         graphics.fillAll(juce::Colours::aquamarine);//getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
@@ -32,6 +37,7 @@ namespace evil
 
     void EvilDAWMainWindowContent::resized() 
     {
+        EVILAUDIO_PROFILE_LAYOUT(*this);
         // This is called when the MainComponent is resized.
         // If you add any child components, this is where you should
         // update their positions.
@@ -43,6 +49,9 @@ namespace evil
             //_liveScrollingAudioVisualiser->setBounds(bounds.removeFromBottom(32));
             //_parametricEqualizerEditor->setBounds(bounds);
         }
+#if EVILAUDIO_PAINT_PROFILING
+        _paintProfilerOverlay.setTopLeftPosition(8, 8);
+#endif
 
     }
 
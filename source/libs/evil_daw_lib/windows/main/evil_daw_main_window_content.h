@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <evilaudio_lookandfeel/evilaudio_lookandfeel.h>
 
 namespace evil
 {
@@ -43,6 +44,11 @@ namespace evil
 
 #pragma endregion
 
+#if EVILAUDIO_PAINT_PROFILING
+        /** Live paint timings of the instrumented components in the window. */
+        EvilAudio_PaintProfilerOverlay _paintProfilerOverlay;
+#endif
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EvilDAWMainWindowContent)
 
     };
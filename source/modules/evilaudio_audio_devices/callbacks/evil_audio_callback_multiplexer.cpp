@@ -0,0 +1,135 @@
+#include "evil_audio_callback_multiplexer.h"
+
+namespace evil
+{
+    AudioCallbackMultiplexer::~AudioCallbackMultiplexer()
+    {
+        // The device manager must stop calling us before we go.
+        jassert(_device == nullptr);
+    }
+
+    void AudioCallbackMultiplexer::addProcessor(juce::AudioIODeviceCallback* callback, int order)
+    {
+        add(callback, Kind::processor, order);
+    }
+
+    void AudioCallbackMultiplexer::addInputTap(juce::AudioIODeviceCallback* callback)
+    {
+        add(callback, Kind::inputTap, 0);
+    }
+
+    void AudioCallbackMultiplexer::addOutputTap(juce::AudioIODeviceCallback* callback)
+    {
+        add(callback, Kind::outputTap, 0);
+    }
+
+    void AudioCallbackMultiplexer::add(juce::AudioIODeviceCallback* callback, Kind kind, int order)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        if (callback == nullptr)
+            return;
+
+        {
+            const juce::ScopedLock sl(_callbackLock);
+            const auto existing = std::find_if(_consumers.begin(), _consumers.end(),
+                                               [callback](const Consumer& c) { return c.callback == callback; });
+            if (existing != _consumers.end())
+                return;
+        }
+
+        // Started outside the lock, so a slow prepare doesn't hold up the audio thread.
+        if (auto* device = _device.load())
+            callback->audioDeviceAboutToStart(device);
+
+        const juce::ScopedLock sl(_callbackLock);
+        const auto position = std::upper_bound(_consumers.begin(), _consumers.end(), std::make_pair(kind, order),
+                                               [](const std::pair<Kind, int>& key, const Consumer& c)
+                                               {
+                                                   return key.first != c.kind ? key.first < c.kind : key.second < c.order;
+                                               });
+        _consumers.insert(position, { callback, kind, order });
+    }
+
+    void AudioCallbackMultiplexer::removeCallback(juce::AudioIODeviceCallback* callback)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        bool removed = false;
+        {
+            const juce::ScopedLock sl(_callbackLock);
+            const auto existing = std::find_if(_consumers.begin(), _consumers.end(),
+                                               [callback](const Consumer& c) { return c.callback == callback; });
+            if (existing != _consumers.end())
+            {
+                _consumers.erase(existing);
+                removed = true;
+            }
+        }
+
+        if (removed && _device != nullptr)
+            callback->audioDeviceStopped();
+    }
+
+    void AudioCallbackMultiplexer::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                                                    int numInputChannels,
+                                                                    float* const* outputChannelData,
+                                                                    int numOutputChannels,
+                                                                    int numSamples,
+                                                                    const juce::AudioIODeviceCallbackContext& context)
+    {
+        for (int i = 0; i < numOutputChannels; ++i)
+            if (outputChannelData[i] != nullptr)
+                juce::FloatVectorOperations::clear(outputChannelData[i], numSamples);
+
+        const juce::ScopedLock sl(_callbackLock);
+
+        for (const auto& consumer : _consumers)
+        {
+            switch (consumer.kind)
+            {
+                case Kind::inputTap:
+                    consumer.callback->audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                                        nullptr, 0, numSamples, context);
+                    break;
+
+                case Kind::processor:
+                    consumer.callback->audioDeviceIOCallbackWithContext(inputChannelData, numInputChannels,
+                                                                        outputChannelData, numOutputChannels, numSamples, context);
+                    break;
+
+                case Kind::outputTap:
+                    consumer.callback->audioDeviceIOCallbackWithContext(outputChannelData, numOutputChannels,
+                                                                        nullptr, 0, numSamples, context);
+                    break;
+            }
+        }
+    }
+
+    void AudioCallbackMultiplexer::audioDeviceAboutToStart(juce::AudioIODevice* device)
+    {
+        _device = device;
+
+        const juce::ScopedLock sl(_callbackLock);
+        for (const auto& consumer : _consumers)
+            consumer.callback->audioDeviceAboutToStart(device);
+    }
+
+    void AudioCallbackMultiplexer::audioDeviceStopped()
+    {
+        {
+            const juce::ScopedLock sl(_callbackLock);
+            for (const auto& consumer : _consumers)
+                consumer.callback->audioDeviceStopped();
+        }
+
+        _device = nullptr;
+    }
+
+    void AudioCallbackMultiplexer::audioDeviceError(const juce::String& errorMessage)
+    {
+        const juce::ScopedLock sl(_callbackLock);
+        for (const auto& consumer : _consumers)
+            consumer.callback->audioDeviceError(errorMessage);
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+namespace evil
+{
+    /**
+     *  A single device callback that runs any number of consumers in a defined order.
+     *
+     *  Register this with the AudioDeviceManager instead of the consumers themselves. For
+     *  every device block it
+     *   1. passes the device's input buffers to the input taps,
+     *   2. clears the output buffers once and runs the processors in ascending order,
+     *      each getting the same input buffers and the outputs the previous ones left,
+     *   3. passes the final outputs to the output taps as their inputs.
+     *
+     *  Nothing is copied: every consumer sees the device's own buffers. Taps get no output
+     *  channels at all, so meters and visualisers can't disturb what the processors wrote.
+     *
+     *  Consumers may be added and removed at any time from the message thread; like the
+     *  AudioDeviceManager, a consumer added while the device runs is started first.
+     */
+    class AudioCallbackMultiplexer final : public juce::AudioIODeviceCallback
+    {
+    public:
+        AudioCallbackMultiplexer() = default;
+        ~AudioCallbackMultiplexer() override;
+
+        /**
+         * Adds a consumer that may write to the outputs.
+         *
+         * @param order Processors run from the lowest order to the highest; ones with the
+         *              same order run in the order they were added.
+         */
+        void addProcessor(juce::AudioIODeviceCallback* callback, int order = 0);
+        /** Adds a read-only consumer of the device's inputs. */
+        void addInputTap(juce::AudioIODeviceCallback* callback);
+        /** Adds a read-only consumer of the final outputs, which it receives as its inputs. */
+        void addOutputTap(juce::AudioIODeviceCallback* callback);
+        /** Removes a consumer of any kind; it is stopped first if the device is running. */
+        void removeCallback(juce::AudioIODeviceCallback* callback);
+
+        void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                              int numInputChannels,
+                                              float* const* outputChannelData,
+                                              int numOutputChannels,
+                                              int numSamples,
+                                              const juce::AudioIODeviceCallbackContext& context) override;
+        void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+        void audioDeviceStopped() override;
+        void audioDeviceError(const juce::String& errorMessage) override;
+
+    private:
+        enum class Kind
+        {
+            inputTap = 0,
+            processor,
+            outputTap
+        };
+
+        struct Consumer
+        {
+            juce::AudioIODeviceCallback* callback = nullptr;
+            Kind kind = Kind::processor;
+            int order = 0;
+        };
+
+        void add(juce::AudioIODeviceCallback* callback, Kind kind, int order);
+
+        /** Held by the audio thread for the whole of a block, and to change _consumers. */
+        juce::CriticalSection _callbackLock;
+        /** Kept sorted by kind, then order, then the order of adding. */
+        std::vector<Consumer> _consumers;
+        /** The running device, or nullptr while stopped. */
+        std::atomic<juce::AudioIODevice*> _device{ nullptr };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMultiplexer)
+    };
+}
@@ -0,0 +1,435 @@
+#include "evil_headless_audio_device.h"
+
+namespace evil
+{
+    std::optional<HeadlessAudioSettings> HeadlessAudioSettings::fromCommandLine(const juce::String& commandLine)
+    {
+        const juce::ArgumentList args(juce::String(), commandLine);
+        if (! args.containsOption("--headless"))
+            return std::nullopt;
+
+        HeadlessAudioSettings settings;
+        const auto getFile = [&args](const juce::String& option)
+        {
+            return args.containsOption(option)
+                ? juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption(option).unquoted())
+                : juce::File();
+        };
+
+        if (args.containsOption("--headless-signal"))
+        {
+            const auto signal = args.getValueForOption("--headless-signal");
+            if (signal == "silence")      settings.signal = Signal::silence;
+            else if (signal == "noise")   settings.signal = Signal::whiteNoise;
+            else if (signal == "sweep")   settings.signal = Signal::sweep;
+            else                          settings.signal = Signal::sine;
+        }
+
+        if (args.containsOption("--headless-frequency"))
+            settings.frequency = juce::jlimit(1.0f, 24000.0f, args.getValueForOption("--headless-frequency").getFloatValue());
+        if (args.containsOption("--headless-rate"))
+            settings.sampleRate = juce::jlimit(8000.0, 384000.0, args.getValueForOption("--headless-rate").getDoubleValue());
+        if (args.containsOption("--headless-block"))
+            settings.bufferSize = juce::jlimit(16, 8192, args.getValueForOption("--headless-block").getIntValue());
+
+        settings.inputFile = getFile("--headless-input");
+        if (settings.inputFile.existsAsFile() && ! args.containsOption("--headless-rate"))
+        {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            if (const std::unique_ptr<juce::AudioFormatReader> reader{ formats.createReaderFor(settings.inputFile) })
+                settings.sampleRate = reader->sampleRate;
+        }
+
+        settings.outputFile = getFile("--headless-output");
+        settings.loopInput = args.containsOption("--headless-loop");
+        settings.realTime = ! args.containsOption("--headless-fast");
+        return settings;
+    }
+
+    //==============================================================================
+    HeadlessAudioIODevice::HeadlessAudioIODevice(const juce::String& deviceName, const HeadlessAudioSettings& settings, bool fileBacked)
+        : juce::AudioIODevice(deviceName, HeadlessAudioIODeviceType::typeName),
+          juce::Thread("Headless audio device"),
+          _settings(settings),
+          _fileBacked(fileBacked)
+    {
+    }
+
+    HeadlessAudioIODevice::~HeadlessAudioIODevice()
+    {
+        close();
+    }
+
+    juce::StringArray HeadlessAudioIODevice::getOutputChannelNames()
+    {
+        juce::StringArray names;
+        for (int i = 0; i < _settings.numOutputChannels; ++i)
+            names.add("Output " + juce::String(i + 1));
+        return names;
+    }
+
+    juce::StringArray HeadlessAudioIODevice::getInputChannelNames()
+    {
+        juce::StringArray names;
+        for (int i = 0; i < _settings.numInputChannels; ++i)
+            names.add("Input " + juce::String(i + 1));
+        return names;
+    }
+
+    juce::Array<double> HeadlessAudioIODevice::getAvailableSampleRates()
+    {
+        juce::Array<double> rates{ 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+        rates.addIfNotAlreadyThere(_settings.sampleRate);
+        rates.sort();
+        return rates;
+    }
+
+    juce::Array<int> HeadlessAudioIODevice::getAvailableBufferSizes()
+    {
+        juce::Array<int> sizes;
+        for (int size = 16; size <= 8192; size *= 2)
+            sizes.add(size);
+        sizes.addIfNotAlreadyThere(_settings.bufferSize);
+        sizes.sort();
+        return sizes;
+    }
+
+    int HeadlessAudioIODevice::getDefaultBufferSize()
+    {
+        return _settings.bufferSize;
+    }
+
+    juce::String HeadlessAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                             double sampleRate, int bufferSizeSamples)
+    {
+        close();
+        _lastError.clear();
+
+        _sampleRate = sampleRate > 0.0 ? sampleRate : _settings.sampleRate;
+        _bufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : _settings.bufferSize;
+        _activeInputs = inputChannels;
+        _activeInputs.setRange(_settings.numInputChannels, juce::jmax(0, _activeInputs.getHighestBit() + 1 - _settings.numInputChannels), false);
+        _activeOutputs = outputChannels;
+        _activeOutputs.setRange(_settings.numOutputChannels, juce::jmax(0, _activeOutputs.getHighestBit() + 1 - _settings.numOutputChannels), false);
+
+        if (_fileBacked && _settings.inputFile != juce::File())
+        {
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            _reader.reset(formats.createReaderFor(_settings.inputFile));
+
+            if (_reader == nullptr)
+                _lastError = "Can't read " + _settings.inputFile.getFullPathName();
+            else if (_reader->sampleRate != _sampleRate)
+                _lastError = _settings.inputFile.getFileName() + " is at " + juce::String(_reader->sampleRate) + " Hz, not " + juce::String(_sampleRate) + " Hz";
+        }
+
+        if (_lastError.isEmpty() && _fileBacked && _settings.outputFile != juce::File())
+        {
+            _settings.outputFile.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream = std::make_unique<juce::FileOutputStream>(_settings.outputFile);
+
+            const auto options = juce::AudioFormatWriterOptions{}
+                                     .withSampleRate(_sampleRate)
+                                     .withNumChannels(juce::jmax(1, _activeOutputs.countNumberOfSetBits()))
+                                     .withBitsPerSample(24);
+            _writer = juce::WavAudioFormat().createWriterFor(stream, options);
+
+            if (_writer == nullptr)
+                _lastError = "Can't write " + _settings.outputFile.getFullPathName();
+        }
+
+        if (_lastError.isNotEmpty())
+        {
+            _reader.reset();
+            _writer.reset();
+            return _lastError;
+        }
+
+        _inputBuffer.setSize(juce::jmax(1, _activeInputs.countNumberOfSetBits()), _bufferSize);
+        _outputBuffer.setSize(juce::jmax(1, _activeOutputs.countNumberOfSetBits()), _bufferSize);
+        _readPosition = 0;
+        _phase = 0.0;
+        _sweepPosition = 0.0;
+        _isOpen = true;
+        return {};
+    }
+
+    void HeadlessAudioIODevice::close()
+    {
+        stop();
+        _isOpen = false;
+        _reader.reset();
+        _writer.reset();    // Finishes the WAV header.
+    }
+
+    bool HeadlessAudioIODevice::isOpen()
+    {
+        return _isOpen;
+    }
+
+    void HeadlessAudioIODevice::start(juce::AudioIODeviceCallback* callback)
+    {
+        if (! _isOpen || callback == nullptr || isThreadRunning())
+            return;
+
+        callback->audioDeviceAboutToStart(this);
+        {
+            const juce::ScopedLock sl(_callbackLock);
+            _callback = callback;
+        }
+
+        _isPlaying = true;
+        startThread(_settings.realTime ? juce::Thread::Priority::highest : juce::Thread::Priority::normal);
+    }
+
+    void HeadlessAudioIODevice::stop()
+    {
+        stopThread(2000);
+        _isPlaying = false;
+
+        juce::AudioIODeviceCallback* callback = nullptr;
+        {
+            const juce::ScopedLock sl(_callbackLock);
+            std::swap(callback, _callback);
+        }
+
+        if (callback != nullptr)
+            callback->audioDeviceStopped();
+    }
+
+    bool HeadlessAudioIODevice::isPlaying()
+    {
+        return _isPlaying;
+    }
+
+    juce::String HeadlessAudioIODevice::getLastError()
+    {
+        return _lastError;
+    }
+
+    int HeadlessAudioIODevice::getCurrentBufferSizeSamples()
+    {
+        return _bufferSize;
+    }
+
+    double HeadlessAudioIODevice::getCurrentSampleRate()
+    {
+        return _sampleRate;
+    }
+
+    int HeadlessAudioIODevice::getCurrentBitDepth()
+    {
+        return 32;
+    }
+
+    juce::BigInteger HeadlessAudioIODevice::getActiveOutputChannels() const
+    {
+        return _activeOutputs;
+    }
+
+    juce::BigInteger HeadlessAudioIODevice::getActiveInputChannels() const
+    {
+        return _activeInputs;
+    }
+
+    int HeadlessAudioIODevice::getOutputLatencyInSamples()
+    {
+        return 0;
+    }
+
+    int HeadlessAudioIODevice::getInputLatencyInSamples()
+    {
+        return 0;
+    }
+
+    void HeadlessAudioIODevice::generateTestSignal()
+    {
+        const auto numSamples = _inputBuffer.getNumSamples();
+        _inputBuffer.clear();
+
+        switch (_settings.signal)
+        {
+            case HeadlessAudioSettings::Signal::silence:
+                break;
+
+            case HeadlessAudioSettings::Signal::sine:
+            case HeadlessAudioSettings::Signal::sweep:
+            {
+                auto* first = _inputBuffer.getWritePointer(0);
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    auto frequency = double(_settings.frequency);
+                    if (_settings.signal == HeadlessAudioSettings::Signal::sweep)
+                    {
+                        frequency = 20.0 * std::pow(1000.0, _sweepPosition / _settings.sweepSeconds);
+                        _sweepPosition += 1.0 / _sampleRate;
+                        if (_sweepPosition >= _settings.sweepSeconds)
+                            _sweepPosition = 0.0;
+                    }
+
+                    first[i] = _settings.level * float(std::sin(_phase));
+                    _phase += juce::MathConstants<double>::twoPi * juce::jmin(frequency, 0.5 * _sampleRate) / _sampleRate;
+                    if (_phase >= juce::MathConstants<double>::twoPi)
+                        _phase -= juce::MathConstants<double>::twoPi;
+                }
+
+                for (int channel = 1; channel < _inputBuffer.getNumChannels(); ++channel)
+                    _inputBuffer.copyFrom(channel, 0, first, numSamples);
+                break;
+            }
+
+            case HeadlessAudioSettings::Signal::whiteNoise:
+                // Independent noise on every channel, so correlation meters read zero.
+                for (int channel = 0; channel < _inputBuffer.getNumChannels(); ++channel)
+                {
+                    auto* samples = _inputBuffer.getWritePointer(channel);
+                    for (int i = 0; i < numSamples; ++i)
+                        samples[i] = _settings.level * (_random.nextFloat() * 2.0f - 1.0f);
+                }
+                break;
+        }
+    }
+
+    bool HeadlessAudioIODevice::readInput()
+    {
+        if (! _fileBacked)
+        {
+            generateTestSignal();
+            return true;
+        }
+
+        _inputBuffer.clear();
+        if (_reader == nullptr)
+            return true;
+
+        const auto numSamples = _inputBuffer.getNumSamples();
+        for (int offset = 0; offset < numSamples;)
+        {
+            if (_readPosition >= _reader->lengthInSamples)
+            {
+                if (! _settings.loopInput || _reader->lengthInSamples == 0)
+                    return offset > 0;
+
+                _readPosition = 0;
+            }
+
+            const auto count = int(juce::jmin(juce::int64(numSamples - offset), _reader->lengthInSamples - _readPosition));
+            // A mono file feeds every input; otherwise channels map one to one.
+            _reader->read(&_inputBuffer, offset, count, _readPosition, true, _inputBuffer.getNumChannels() > 1);
+            if (_reader->numChannels == 1)
+                for (int channel = 1; channel < _inputBuffer.getNumChannels(); ++channel)
+                    _inputBuffer.copyFrom(channel, offset, _inputBuffer, 0, offset, count);
+
+            _readPosition += count;
+            offset += count;
+        }
+
+        return true;
+    }
+
+    void HeadlessAudioIODevice::run()
+    {
+        const auto blockMilliseconds = 1000.0 * _bufferSize / _sampleRate;
+        auto deadline = juce::Time::getMillisecondCounterHiRes();
+        const juce::AudioIODeviceCallbackContext context{};
+
+        while (! threadShouldExit())
+        {
+            const auto hasInput = readInput();
+            if (! hasInput)
+                break;
+
+            _outputBuffer.clear();
+            {
+                const juce::ScopedLock sl(_callbackLock);
+                if (_callback != nullptr)
+                    _callback->audioDeviceIOCallbackWithContext(_inputBuffer.getArrayOfReadPointers(), _activeInputs.countNumberOfSetBits(),
+                                                                _outputBuffer.getArrayOfWritePointers(), _activeOutputs.countNumberOfSetBits(),
+                                                                _bufferSize, context);
+            }
+
+            if (_writer != nullptr)
+                _writer->writeFromAudioSampleBuffer(_outputBuffer, 0, _bufferSize);
+
+            if (! _settings.realTime)
+                continue;
+
+            // Paced against the clock rather than by sleeping a block's worth, so the rate
+            // doesn't drift; after a long stall it catches up from now instead of bursting.
+            deadline += blockMilliseconds;
+            const auto now = juce::Time::getMillisecondCounterHiRes();
+            if (now - deadline > 4.0 * blockMilliseconds)
+                deadline = now;
+            else if (deadline > now)
+                wait(deadline - now);
+        }
+
+        _isPlaying = false;
+
+        if (! threadShouldExit() && _settings.onInputFinished != nullptr)
+            juce::MessageManager::callAsync(_settings.onInputFinished);
+    }
+
+    //==============================================================================
+    HeadlessAudioIODeviceType::HeadlessAudioIODeviceType(const HeadlessAudioSettings& settings)
+        : juce::AudioIODeviceType(typeName),
+          _settings(settings)
+    {
+    }
+
+    juce::String HeadlessAudioIODeviceType::install(juce::AudioDeviceManager& deviceManager, const HeadlessAudioSettings& settings)
+    {
+        deviceManager.addAudioDeviceType(std::make_unique<HeadlessAudioIODeviceType>(settings));
+        deviceManager.setCurrentAudioDeviceType(typeName, true);
+
+        const auto deviceName = juce::String(settings.usesFiles() ? fileDeviceName : testSignalDeviceName);
+
+        juce::AudioDeviceManager::AudioDeviceSetup setup;
+        setup.outputDeviceName = deviceName;
+        setup.inputDeviceName = deviceName;
+        setup.sampleRate = settings.sampleRate;
+        setup.bufferSize = settings.bufferSize;
+        setup.useDefaultInputChannels = true;
+        setup.useDefaultOutputChannels = true;
+        return deviceManager.setAudioDeviceSetup(setup, true);
+    }
+
+    void HeadlessAudioIODeviceType::scanForDevices()
+    {
+    }
+
+    juce::StringArray HeadlessAudioIODeviceType::getDeviceNames(bool wantInputNames) const
+    {
+        juce::ignoreUnused(wantInputNames);
+        return { testSignalDeviceName, fileDeviceName };
+    }
+
+    int HeadlessAudioIODeviceType::getDefaultDeviceIndex(bool forInput) const
+    {
+        juce::ignoreUnused(forInput);
+        return _settings.usesFiles() ? 1 : 0;
+    }
+
+    int HeadlessAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const
+    {
+        return device != nullptr ? getDeviceNames(asInput).indexOf(device->getName()) : -1;
+    }
+
+    bool HeadlessAudioIODeviceType::hasSeparateInputsAndOutputs() const
+    {
+        return false;
+    }
+
+    juce::AudioIODevice* HeadlessAudioIODeviceType::createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName)
+    {
+        const auto name = outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName;
+        if (name == testSignalDeviceName)
+            return new HeadlessAudioIODevice(name, _settings, false);
+        if (name == fileDeviceName)
+            return new HeadlessAudioIODevice(name, _settings, true);
+
+        return nullptr;
+    }
+}
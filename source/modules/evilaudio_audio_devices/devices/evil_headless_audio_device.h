@@ -0,0 +1,163 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace evil
+{
+    /** How the headless devices generate and consume audio. */
+    struct HeadlessAudioSettings
+    {
+        enum class Signal
+        {
+            silence = 0,
+            sine,
+            whiteNoise,
+            /** A logarithmic sweep from 20 Hz to 20 kHz, repeated every sweepSeconds. */
+            sweep
+        };
+
+        /** What the "Test Signal" device feeds to its inputs. */
+        Signal signal = Signal::sine;
+        float frequency = 1000.0f;
+        /** Peak level of the test signal, as a gain. */
+        float level = 0.25f;
+        double sweepSeconds = 10.0;
+
+        /** The "WAV File" device reads its inputs from here, if it is set... */
+        juce::File inputFile;
+        /** ...and writes its outputs here as 24-bit WAV, if it is set. */
+        juce::File outputFile;
+        /** Start the input file again when it ends, instead of finishing. */
+        bool loopInput = false;
+
+        /** Clock the callbacks like a sound card would; otherwise run as fast as possible. */
+        bool realTime = true;
+        double sampleRate = 48000.0;
+        int bufferSize = 512;
+        int numInputChannels = 2;
+        int numOutputChannels = 2;
+
+        /** Called on the message thread once the input file has been played to its end. */
+        std::function<void()> onInputFinished;
+
+        /**
+         * Reads the settings from command-line options, or returns nothing unless --headless
+         * is given. The other options are:
+         *   --headless-signal=silence|sine|noise|sweep   --headless-frequency=HZ
+         *   --headless-input=FILE   --headless-output=FILE   --headless-loop
+         *   --headless-fast   --headless-rate=HZ   --headless-block=SAMPLES
+         * Giving an input or output file selects the "WAV File" device, which runs at the
+         * input file's sample rate unless --headless-rate is given.
+         */
+        static std::optional<HeadlessAudioSettings> fromCommandLine(const juce::String& commandLine);
+
+        /** True if the input or output file is set. */
+        bool usesFiles() const noexcept { return inputFile != juce::File() || outputFile != juce::File(); }
+    };
+
+    /**
+     *  An audio device that needs no sound card.
+     *
+     *  A thread of its own drives the callback in blocks of the chosen size, either paced to
+     *  real time against the high-resolution clock or back to back. The inputs come from a
+     *  test signal or a WAV file and the outputs can be written to a WAV file, so the same
+     *  callback path as with real hardware runs in CI containers, on render nodes and in
+     *  benchmarks.
+     */
+    class HeadlessAudioIODevice final : public juce::AudioIODevice,
+                                        private juce::Thread
+    {
+    public:
+        HeadlessAudioIODevice(const juce::String& deviceName, const HeadlessAudioSettings& settings, bool fileBacked);
+        ~HeadlessAudioIODevice() override;
+
+        juce::StringArray getOutputChannelNames() override;
+        juce::StringArray getInputChannelNames() override;
+        juce::Array<double> getAvailableSampleRates() override;
+        juce::Array<int> getAvailableBufferSizes() override;
+        int getDefaultBufferSize() override;
+
+        juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                          double sampleRate, int bufferSizeSamples) override;
+        void close() override;
+        bool isOpen() override;
+        void start(juce::AudioIODeviceCallback* callback) override;
+        void stop() override;
+        bool isPlaying() override;
+        juce::String getLastError() override;
+
+        int getCurrentBufferSizeSamples() override;
+        double getCurrentSampleRate() override;
+        int getCurrentBitDepth() override;
+        juce::BigInteger getActiveOutputChannels() const override;
+        juce::BigInteger getActiveInputChannels() const override;
+        int getOutputLatencyInSamples() override;
+        int getInputLatencyInSamples() override;
+
+    private:
+        void run() override;
+        /** Fills the input buffer; returns false once the input file has ended. */
+        bool readInput();
+        void generateTestSignal();
+
+        const HeadlessAudioSettings _settings;
+        const bool _fileBacked;
+
+        bool _isOpen = false;
+        std::atomic<bool> _isPlaying{ false };
+        juce::String _lastError;
+        double _sampleRate = 0.0;
+        int _bufferSize = 0;
+        juce::BigInteger _activeInputs, _activeOutputs;
+
+        juce::CriticalSection _callbackLock;
+        juce::AudioIODeviceCallback* _callback = nullptr;
+
+        /** Device thread only while playing. */
+        juce::AudioBuffer<float> _inputBuffer, _outputBuffer;
+        std::unique_ptr<juce::AudioFormatReader> _reader;
+        std::unique_ptr<juce::AudioFormatWriter> _writer;
+        juce::int64 _readPosition = 0;
+        double _phase = 0.0;
+        double _sweepPosition = 0.0;
+        juce::Random _random;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessAudioIODevice)
+    };
+
+    /**
+     *  The "Headless" device type, offering a "Test Signal" and a "WAV File" device.
+     *
+     *  Add it to an AudioDeviceManager with install(), or with addAudioDeviceType() and
+     *  setCurrentAudioDeviceType() like any other type.
+     */
+    class HeadlessAudioIODeviceType final : public juce::AudioIODeviceType
+    {
+    public:
+        explicit HeadlessAudioIODeviceType(const HeadlessAudioSettings& settings);
+
+        static constexpr const char* typeName = "Headless";
+        static constexpr const char* testSignalDeviceName = "Test Signal";
+        static constexpr const char* fileDeviceName = "WAV File";
+
+        /**
+         * Adds the type to a device manager and opens the device the settings ask for.
+         *
+         * @return An error message, or an empty string on success.
+         */
+        static juce::String install(juce::AudioDeviceManager& deviceManager, const HeadlessAudioSettings& settings);
+
+        void scanForDevices() override;
+        juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+        int getDefaultDeviceIndex(bool forInput) const override;
+        int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+        bool hasSeparateInputsAndOutputs() const override;
+        juce::AudioIODevice* createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName) override;
+
+    private:
+        const HeadlessAudioSettings _settings;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessAudioIODeviceType)
+    };
+}
@@ -9,3 +9,6 @@
 #endif
 
 #include "evilaudio_audio_devices.h"
+
+#include "callbacks/evil_audio_callback_multiplexer.cpp"
+#include "devices/evil_headless_audio_device.cpp"
@@ -16,7 +16,7 @@
   license:            AGPLv3/Commercial
   minimumCppStandard: 17
 
-  dependencies:       juce_audio_basics, juce_events
+  dependencies:       juce_audio_basics, juce_audio_devices, juce_audio_formats, juce_events
 
   OSXFrameworks:      CoreAudio CoreMIDI AudioToolbox
   iOSFrameworks:      CoreAudio CoreMIDI AudioToolbox AVFoundation
@@ -26,3 +26,5 @@
 
 ****************************************************************************/
 
+#include "callbacks/evil_audio_callback_multiplexer.h"
+#include "devices/evil_headless_audio_device.h"
@@ -1,123 +1,429 @@
 #pragma once
 
 #include "juce_dsp/juce_dsp.h"
+#include "AnalyserBase.h"
+#include "FftBackend.h"
+#include "SpectrumColumnMap.h"
+#include "TripleBuffer.h"
 
+/** A finished, averaged magnitude spectrum handed from the analysis worker to the editor. */
+struct SpectrumFrame
+{
+    std::vector<float> magnitudes;
+    /** The right or side channel in the L/R and M/S channel modes, empty otherwise. */
+    std::vector<float> secondMagnitudes;
+    double sampleRate = 0.0;
+    int fftSize = 0;
+};
+
+/**
+ *  Short-time spectrum of the audio passing one point of the equaliser.
+ *
+ *  Mixes the channels down according to the channel mode into one stream, or splits them
+ *  into two for the L/R and M/S modes, and publishes an averaged magnitude spectrum per frame.
+ */
 template<typename Type>
-class Analyser : public juce::Thread
+class Analyser : public AnalyserBase
 {
 public:
-    Analyser() : juce::Thread("Equaliser-Analyser")
+    /**
+     * @param audioLock Lock held by the audio thread while it calls addAudioData(), so
+     *                  the analyser storage can be swapped in and out safely.
+     */
+    explicit Analyser(const juce::CriticalSection& audioLock)
+        : AnalyserBase(audioLock)
     {
-        averager.clear();
     }
 
-    ~Analyser() override = default;
+    ~Analyser() override
+    {
+        stopAnalysis();
+    }
 
+    /**
+     * Feeds a block into the analyser, mixed down according to the channel mode. Audio thread only.
+     *
+     * Wait-free with bounded work: if the analysis has fallen behind, the oldest samples
+     * in the ring are overwritten rather than the new block being dropped. The two-stream
+     * modes derive both streams in one pass over the block.
+     */
     void addAudioData(const juce::AudioBuffer<Type>& buffer, int startChannel, int numChannels)
     {
-        if (abstractFifo.getFreeSpace() < buffer.getNumSamples())
+        // Nothing is observing this analyser, so don't spend any time on the audio thread.
+        auto* storage = getStorage();
+        if (storage == nullptr || numChannels <= 0)
             return;
 
-        int start1, block1, start2, block2;
-        abstractFifo.prepareToWrite(buffer.getNumSamples(), start1, block1, start2, block2);
-        audioFifo.copyFrom(0, start1, buffer.getReadPointer(startChannel), block1);
-        if (block2 > 0)
-            audioFifo.copyFrom(0, start2, buffer.getReadPointer(startChannel, block1), block2);
+        using ChannelMode = AnalyserSettings::ChannelMode;
 
-        for (int channel = startChannel + 1; channel < startChannel + numChannels; ++channel)
+        const auto numSamples = buffer.getNumSamples();
+        const auto rightChannel = startChannel + juce::jmin(1, numChannels - 1);
+        const auto* left = buffer.getReadPointer(startChannel);
+        const auto* right = buffer.getReadPointer(rightChannel);
+
+        const auto mode = ChannelMode(channelMode.load(std::memory_order_relaxed));
+        switch (mode)
         {
-            if (block1 > 0) audioFifo.addFrom(0, start1, buffer.getReadPointer(channel), block1);
-            if (block2 > 0) audioFifo.addFrom(0, start2, buffer.getReadPointer(channel, block1), block2);
+            case ChannelMode::mono:
+            {
+                const auto* const* channels = buffer.getArrayOfReadPointers() + startChannel;
+                storage->ring.write(numSamples, [channels, numChannels](float* __restrict mono, int offset, int count)
+                {
+                    for (int i = 0; i < count; ++i)
+                    {
+                        auto sum = channels[0][offset + i];
+                        for (int channel = 1; channel < numChannels; ++channel)
+                            sum += channels[channel][offset + i];
+                        mono[i] = sum;
+                    }
+                });
+                storage->secondRing.skip(numSamples);
+                break;
+            }
+            case ChannelMode::left:
+            case ChannelMode::right:
+            {
+                const auto* source = mode == ChannelMode::left ? left : right;
+                storage->ring.write(numSamples, [source](float* __restrict dest, int offset, int count)
+                {
+                    juce::FloatVectorOperations::copy(dest, source + offset, count);
+                });
+                storage->secondRing.skip(numSamples);
+                break;
+            }
+            case ChannelMode::leftRight:
+                AnalyserRing::writePair(storage->ring, storage->secondRing, numSamples,
+                    [left, right](float* __restrict l, float* __restrict r, int offset, int count)
+                    {
+                        for (int i = 0; i < count; ++i)
+                        {
+                            l[i] = left[offset + i];
+                            r[i] = right[offset + i];
+                        }
+                    });
+                break;
+            case ChannelMode::midSide:
+                AnalyserRing::writePair(storage->ring, storage->secondRing, numSamples,
+                    [left, right](float* __restrict mid, float* __restrict side, int offset, int count)
+                    {
+                        for (int i = 0; i < count; ++i)
+                        {
+                            mid[i] = 0.5f * (left[offset + i] + right[offset + i]);
+                            side[i] = 0.5f * (left[offset + i] - right[offset + i]);
+                        }
+                    });
+                break;
         }
-        abstractFifo.finishedWrite(block1 + block2);
-        waitForData.signal();
+
+        notifyIfReady();
+    }
+
+    /**
+     * Builds a path through the latest spectrum at the resolution of the plot. Message thread only.
+     *
+     * The bin-to-column mapping is cached and only rebuilt when the plot width, sample rate
+     * or FFT size changes.
+     *
+     * @param secondStream Draw the right or side channel of a two-stream channel mode; the
+     *                     path is left empty if the current mode only has one stream.
+     */
+    void createPath(juce::Path& p, const juce::Rectangle<float> bounds, float minFreq, bool secondStream = false)
+    {
+        p.clear();
+        auto* storage = getStorage();
+        if (storage == nullptr)
+            return;
+
+        // Never blocks: if no new frame has been published we just redraw the last one.
+        // The second stream is drawn straight after the first, from the same frame.
+        if (! secondStream)
+            storage->frames.acquire();
+
+        const auto& frame = storage->frames.getReadBuffer();
+        const auto& magnitudes = secondStream ? frame.secondMagnitudes : frame.magnitudes;
+        if (magnitudes.empty())
+            return;
+
+        columnMap.update(juce::roundToInt(bounds.getWidth()), frame.sampleRate, frame.fftSize, minFreq, 10.0f);
+        columnMap.createPath(p, magnitudes.data(), bounds);
     }
 
-    void setupAnalyser(int audioFifoSize, Type sampleRateToUse)
+    /**
+     * Returns the newest published frame, or nullptr while nothing is subscribed. Message
+     * thread only; the frame stays valid until the next call to this or createPath().
+     */
+    const SpectrumFrame* getLatestFrame()
     {
-        sampleRate = sampleRateToUse;
-        audioFifo.setSize(1, audioFifoSize);
-        abstractFifo.setTotalSize(audioFifoSize);
-        startThread(juce::Thread::Priority::normal);
+        auto* storage = getStorage();
+        if (storage == nullptr)
+            return nullptr;
+
+        storage->frames.acquire();
+        return &storage->frames.getReadBuffer();
     }
 
-    void run() override
+private:
+    /**
+     * The FFT, window and averaging state for one set of AnalyserSettings. Only ever
+     * touched by the worker running the job, which replaces it when the settings change.
+     */
+    struct Pipeline
     {
-        while (!threadShouldExit())
+        /** Buffers and running average of one analysed stream. */
+        struct Stream
         {
-            if (abstractFifo.getNumReady() >= fft.getSize())
+            Stream(int fftSize, int historyFrames)
+                : fftBuffer(size_t(fftSize), 0.0f),
+                  magnitudes(size_t(fftSize / 2), 0.0f),
+                  average(size_t(fftSize / 2), 0.0f),
+                  history(historyFrames, fftSize / 2)
             {
-                fftBuffer.clear();
+                history.clear();
+            }
+
+            std::vector<float> fftBuffer;
+            std::vector<float> magnitudes;
+            std::vector<float> average;
+            juce::AudioBuffer<float> history;
+            int historySlot = 0;
+            bool isWarmingUp = true;
+        };
+
+        Pipeline(const AnalyserSettings& settingsToUse, double sampleRate, EqualiserTables& tables)
+            : settings(settingsToUse),
+              fftSize(settings.getFftSize()),
+              hopSize(settings.getHopSize(sampleRate)),
+              fft(FftBackend::create(juce::jlimit(AnalyserSettings::minFftOrder, AnalyserSettings::maxFftOrder, settings.fftOrder))),
+              window(tables.getWindowTable(size_t(fftSize), settings.window))
+        {
+            streams.reserve(2);
+            for (int i = 0; i < settings.getNumStreams(); ++i)
+                streams.emplace_back(fftSize, juce::jlimit(1, AnalyserSettings::maxBoxcarFrames, settings.boxcarFrames));
+
+            // Scale by the window's coherent gain, so switching windows doesn't shift the display.
+            const auto windowSum = std::accumulate(window.begin(), window.end(), 0.0f);
+            gain = windowSum > 0.0f ? 1.0f / windowSum : 0.0f;
+
+            const auto hopSeconds = sampleRate > 0.0 ? float(hopSize / sampleRate) : 0.0f;
+            smoothing = 1.0f - std::exp(-hopSeconds / juce::jmax(0.001f, settings.averagingTimeSeconds));
+            peakDecay = juce::Decibels::decibelsToGain(-juce::jlimit(0.0f, AnalyserSettings::maxPeakDecayDbPerSecond,
+                                                                     settings.peakDecayDbPerSecond) * hopSeconds);
+
+            if (settings.octaveFraction > 0)
+                prepareSmoothing();
+        }
 
-                int start1, block1, start2, block2;
-                abstractFifo.prepareToRead(fft.getSize(), start1, block1, start2, block2);
-                if (block1 > 0) fftBuffer.copyFrom(0, 0, audioFifo.getReadPointer(0, start1), block1);
-                if (block2 > 0) fftBuffer.copyFrom(0, block1, audioFifo.getReadPointer(0, start2), block2);
-                abstractFifo.finishedRead((block1 + block2) / 2);
+        /** Writes a stream's averaged spectrum, smoothed if the settings ask for it. */
+        void render(const Stream& stream, std::vector<float>& dest)
+        {
+            dest.resize(stream.average.size());
 
-                windowing.multiplyWithWindowingTable(fftBuffer.getWritePointer(0), size_t(fft.getSize()));
-                fft.performFrequencyOnlyForwardTransform(fftBuffer.getWritePointer(0));
+            if (settings.octaveFraction > 0)
+                smooth(stream.average, dest.data());
+            else
+                juce::FloatVectorOperations::copy(dest.data(), stream.average.data(), int(dest.size()));
+        }
 
-                juce::ScopedLock lockedForWriting(pathCreationLock);
-                averager.addFrom(0, 0, averager.getReadPointer(averagerPtr), averager.getNumSamples(), -1.0f);
-                averager.copyFrom(averagerPtr, 0, fftBuffer.getReadPointer(0), averager.getNumSamples(), 1.0f / (averager.getNumSamples() * (averager.getNumChannels() - 1)));
-                averager.addFrom(0, 0, averager.getReadPointer(averagerPtr), averager.getNumSamples());
-                if (++averagerPtr == averager.getNumChannels()) averagerPtr = 1;
+        /**
+         * Writes the averaged spectrum smoothed over 1/N octave around every bin.
+         *
+         * The power is summed once into a prefix array, after which every bin's band is a
+         * single subtraction; the cost doesn't depend on how wide the bands are.
+         */
+        void smooth(const std::vector<float>& average, float* dest)
+        {
+            const auto numBins = average.size();
 
-                newDataAvailable = true;
+            prefix[0] = 0.0;
+            for (size_t k = 0; k < numBins; ++k)
+                prefix[k + 1] = prefix[k] + double(average[k]) * double(average[k]);
+
+            for (size_t k = 0; k < numBins; ++k)
+            {
+                const auto low = size_t(smoothingLow[k]);
+                const auto high = size_t(smoothingHigh[k]);
+                dest[k] = float(std::sqrt((prefix[high] - prefix[low]) / double(high - low)));
             }
+        }
+
+        /** Works out the band [low, high) of bins averaged for each bin. */
+        void prepareSmoothing()
+        {
+            const auto numBins = fftSize / 2;
+            const auto halfBandwidth = std::pow(2.0, 0.5 / settings.octaveFraction);
 
-            if (abstractFifo.getNumReady() < fft.getSize())
-                waitForData.wait(100);
+            smoothingLow.resize(size_t(numBins));
+            smoothingHigh.resize(size_t(numBins));
+            prefix.resize(size_t(numBins + 1));
+
+            for (int k = 0; k < numBins; ++k)
+            {
+                smoothingLow[size_t(k)] = juce::jlimit(0, k, int(std::ceil(k / halfBandwidth)));
+                smoothingHigh[size_t(k)] = juce::jlimit(k + 1, numBins, int(std::floor(k * halfBandwidth)) + 1);
+            }
         }
-    }
 
-    void createPath(juce::Path& p, const juce::Rectangle<float> bounds, float minFreq)
+        /** Folds a stream's latest raw FFT magnitudes into its running average. */
+        void accumulate(Stream& stream)
+        {
+            const auto numBins = int(stream.average.size());
+            auto* magnitudes = stream.magnitudes.data();
+            auto* averaged = stream.average.data();
+            auto& history = stream.history;
+
+            juce::FloatVectorOperations::multiply(magnitudes, gain, numBins);
+
+            if (stream.isWarmingUp)
+            {
+                // Seed every averaging slot with the first frame so a newly opened view
+                // shows a settled spectrum straight away instead of fading in from silence.
+                const auto slotGain = 1.0f / history.getNumChannels();
+                for (int slot = 0; slot < history.getNumChannels(); ++slot)
+                    history.copyFrom(slot, 0, magnitudes, numBins, slotGain);
+                juce::FloatVectorOperations::copy(averaged, magnitudes, numBins);
+                stream.isWarmingUp = false;
+                return;
+            }
+
+            switch (settings.averaging)
+            {
+                case AnalyserSettings::Averaging::boxcar:
+                {
+                    // Running sum: take the oldest frame out, put the newest in.
+                    auto& slot = stream.historySlot;
+                    juce::FloatVectorOperations::subtract(averaged, history.getReadPointer(slot), numBins);
+                    history.copyFrom(slot, 0, magnitudes, numBins, 1.0f / history.getNumChannels());
+                    juce::FloatVectorOperations::add(averaged, history.getReadPointer(slot), numBins);
+                    if (++slot == history.getNumChannels()) slot = 0;
+                    break;
+                }
+                case AnalyserSettings::Averaging::exponential:
+                    juce::FloatVectorOperations::multiply(averaged, 1.0f - smoothing, numBins);
+                    juce::FloatVectorOperations::addWithMultiply(averaged, magnitudes, smoothing, numBins);
+                    break;
+                case AnalyserSettings::Averaging::peakHold:
+                    juce::FloatVectorOperations::multiply(averaged, peakDecay, numBins);
+                    juce::FloatVectorOperations::max(averaged, averaged, magnitudes, numBins);
+                    break;
+            }
+        }
+
+        const AnalyserSettings settings;
+        const int fftSize;
+        const int hopSize;
+        std::unique_ptr<FftBackend> fft;
+        const std::vector<float>& window;
+        std::vector<Stream> streams;
+        float gain = 1.0f;
+        float smoothing = 1.0f;
+        float peakDecay = 0.0f;
+        std::vector<int> smoothingLow, smoothingHigh;
+        std::vector<double> prefix;
+    };
+
+    /** Everything the analyser needs while it is running, allocated on demand. */
+    struct Storage : public AnalyserStorage
     {
-        p.clear();
-        p.preallocateSpace(8 + averager.getNumSamples() * 3);
+        Storage(int audioFifoSize, double sampleRateToUse, const AnalyserSettings& settings, EqualiserTables& tables)
+            : AnalyserStorage(audioFifoSize, sampleRateToUse),
+              pipeline(std::make_unique<Pipeline>(settings, sampleRateToUse, tables))
+        {
+            frameSize = pipeline->fftSize;
+            frames.forEachBuffer([this](SpectrumFrame& frame)
+            {
+                frame.magnitudes.assign(size_t(pipeline->fftSize / 2), 0.0f);
+                frame.sampleRate = sampleRate;
+                frame.fftSize = pipeline->fftSize;
+            });
+        }
 
-        juce::ScopedLock lockedForReading(pathCreationLock);
-        const auto* fftData = averager.getReadPointer(0);
-        const auto  factor = bounds.getWidth() / 10.0f;
+        void rebuildPipeline(const AnalyserSettings& settings, EqualiserTables& tables) override
+        {
+            const auto numStreams = pipeline->streams.size();
+            pipeline = std::make_unique<Pipeline>(settings, sampleRate, tables);
 
-        p.startNewSubPath(bounds.getX() + factor * indexToX(0, minFreq), binToY(fftData[0], bounds));
-        for (int i = 0; i < averager.getNumSamples(); ++i)
-            p.lineTo(bounds.getX() + factor * indexToX(float(i), minFreq), binToY(fftData[i], bounds));
+            // What secondRing holds from before a two-stream mode was chosen is stale.
+            if (pipeline->streams.size() > numStreams)
+                readPosition.store(getWritePosition(), std::memory_order_relaxed);
+
+            frameSize.store(pipeline->fftSize, std::memory_order_relaxed);
+        }
+
+        int getHopSize() const override
+        {
+            return pipeline->hopSize;
+        }
+
+        /**
+         * Reads the mono, left, right, left or mid stream from ring, the right or side one from
+         * secondRing. The single-stream modes only move secondRing's positions on, so its
+         * samples are stale and are never read then.
+         */
+        bool readFrame(juce::uint64 position) override
+        {
+            for (size_t i = 0; i < pipeline->streams.size(); ++i)
+            {
+                const auto& source = i == 0 ? ring : secondRing;
+                if (! source.read(position, pipeline->streams[i].fftBuffer.data(), pipeline->fftSize))
+                    return false;
+            }
+            return true;
+        }
+
+        juce::uint64 getFrameGeneration() const noexcept override
+        {
+            return frames.getGeneration();
+        }
+
+        std::unique_ptr<Pipeline> pipeline;
+        TripleBuffer<SpectrumFrame> frames;
+    };
+
+    Storage* getStorage() const noexcept
+    {
+        return static_cast<Storage*>(AnalyserBase::getStorage());
     }
 
-    bool checkForNewData()
+    std::unique_ptr<AnalyserStorage> createStorage(int audioFifoSize, double sampleRate,
+                                                   const AnalyserSettings& settings, EqualiserTables& tables) override
     {
-        auto available = newDataAvailable.load();
-        newDataAvailable.store(false);
-        return available;
+        return std::make_unique<Storage>(audioFifoSize, sampleRate, settings, tables);
     }
 
-private:
-    inline float indexToX(float index, float minFreq) const
+    void settingsChanging(const AnalyserSettings& newSettings) override
     {
-        const auto freq = (sampleRate * index) / fft.getSize();
-        return (freq > 0.01f) ? std::log(freq / minFreq) / std::log(2.0f) : 0.0f;
+        channelMode = int(newSettings.channelMode);
     }
 
-    inline float binToY(float bin, const juce::Rectangle<float> bounds) const
+    void processFrame() override
     {
-        const float infinity = -80.0f;
-        return juce::jmap(juce::Decibels::gainToDecibels(bin, infinity),
-            infinity, 0.0f, bounds.getBottom(), bounds.getY());
+        auto& storage = *getStorage();
+        auto& pipeline = *storage.pipeline;
+        const auto fftSize = pipeline.fftSize;
+
+        for (auto& stream : pipeline.streams)
+        {
+            juce::FloatVectorOperations::multiply(stream.fftBuffer.data(), pipeline.window.data(), fftSize);
+            pipeline.fft->performMagnitudes(stream.fftBuffer.data(), stream.magnitudes.data());
+            pipeline.accumulate(stream);
+        }
+
+        // Hand the averaged spectrum over to the editor without either side having to wait.
+        // The write buffer belongs to this thread, so it may be resized after a settings change.
+        auto& frame = storage.frames.getWriteBuffer();
+        frame.sampleRate = storage.sampleRate;
+        frame.fftSize = fftSize;
+        pipeline.render(pipeline.streams[0], frame.magnitudes);
+        if (pipeline.streams.size() > 1)
+            pipeline.render(pipeline.streams[1], frame.secondMagnitudes);
+        else
+            frame.secondMagnitudes.clear();
+        storage.frames.publish();
     }
 
-    juce::WaitableEvent waitForData;
-    juce::CriticalSection pathCreationLock;
-    Type sampleRate{};
-    juce::dsp::FFT fft{ 12 };
-    juce::dsp::WindowingFunction<Type> windowing{ size_t(fft.getSize()), juce::dsp::WindowingFunction<Type>::hann, true };
-    juce::AudioBuffer<float> fftBuffer{ 1, fft.getSize() * 2 };
-    juce::AudioBuffer<float> averager{ 5, fft.getSize() / 2 };
-    int averagerPtr = 1;
-    juce::AbstractFifo abstractFifo{ 48000 };
-    juce::AudioBuffer<Type> audioFifo;
-    std::atomic<bool> newDataAvailable;
+    SpectrumColumnMap columnMap;
+    /** The settings' channel mode, for the audio thread. */
+    std::atomic<int> channelMode{ int(AnalyserSettings::ChannelMode::mono) };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Analyser)
 };
@@ -0,0 +1,213 @@
+#include "AnalyserBase.h"
+
+AnalyserStorage::AnalyserStorage(int audioFifoSize, double sampleRateToUse)
+    : ring(juce::jmax(audioFifoSize, (1 << AnalyserSettings::maxFftOrder) * 2)),
+      secondRing(ring.getCapacity()),
+      sampleRate(sampleRateToUse)
+{
+}
+
+juce::uint64 AnalyserStorage::getWritePosition() const noexcept
+{
+    return juce::jmin(ring.getWritePosition(), secondRing.getWritePosition());
+}
+
+bool AnalyserStorage::hasOverwritten(juce::uint64 position) const noexcept
+{
+    return ring.hasOverwritten(position) || secondRing.hasOverwritten(position);
+}
+
+//==============================================================================
+
+AnalyserBase::AnalyserBase(const juce::CriticalSection& audioLockToUse)
+    : audioLock(audioLockToUse)
+{
+}
+
+AnalyserBase::~AnalyserBase()
+{
+    // The derived class must have stopped the analysis while its processFrame() still existed.
+    jassert(storage == nullptr);
+}
+
+void AnalyserBase::stopAnalysis()
+{
+    cancelPendingUpdate();
+    releaseStorage();
+}
+
+void AnalyserBase::setupAnalyser(int audioFifoSize, double sampleRateToUse)
+{
+    pendingSampleRate = sampleRateToUse;
+    pendingFifoSize = audioFifoSize;
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        handleAsyncUpdate();
+    else
+        triggerAsyncUpdate();
+}
+
+void AnalyserBase::addSubscriber()
+{
+    if (++subscribers == 1)
+        allocateStorage();
+}
+
+void AnalyserBase::removeSubscriber()
+{
+    jassert(subscribers > 0);
+    if (--subscribers == 0)
+        releaseStorage();
+}
+
+bool AnalyserBase::hasSubscribers() const noexcept
+{
+    return subscribers > 0;
+}
+
+void AnalyserBase::setSubscriberVisible(bool isVisible)
+{
+    visibleSubscribers += isVisible ? 1 : -1;
+    jassert(visibleSubscribers >= 0);
+    setJobVisible(visibleSubscribers > 0);
+}
+
+void AnalyserBase::setSettings(const AnalyserSettings& newSettings)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(settingsLock);
+        if (pendingSettings == newSettings)
+            return;
+        pendingSettings = newSettings;
+    }
+    settingsChanging(newSettings);
+    settingsChanged = true;
+    scheduler->notify();
+}
+
+AnalyserSettings AnalyserBase::getSettings() const
+{
+    const juce::SpinLock::ScopedLockType sl(settingsLock);
+    return pendingSettings;
+}
+
+bool AnalyserBase::isJobReady() const
+{
+    if (storage == nullptr)
+        return false;
+
+    // New settings are applied even if the audio has stopped.
+    return settingsChanged.load(std::memory_order_relaxed)
+        || storage->getWritePosition() >= storage->readPosition.load(std::memory_order_relaxed)
+                                          + juce::uint64(storage->frameSize.load(std::memory_order_relaxed));
+}
+
+void AnalyserBase::notifyIfReady()
+{
+    // Only flag the job once there is a whole frame for a worker to process.
+    if (isJobReady())
+        scheduler->notifyJobReady();
+}
+
+void AnalyserBase::runJob()
+{
+    if (settingsChanged.exchange(false))
+        storage->rebuildPipeline(getSettings(), *sharedTables);
+
+    const auto fftSize = juce::uint64(storage->frameSize.load(std::memory_order_relaxed));
+    const auto writePosition = storage->getWritePosition();
+    auto readPosition = storage->readPosition.load(std::memory_order_relaxed);
+
+    if (writePosition < readPosition + fftSize)
+        return;
+
+    // If the audio thread has lapped us (or is about to), skip straight to the newest
+    // whole frame. Stale frames aren't worth analysing, and this bounds the work per call.
+    // Both rings skip together, so they stay aligned.
+    const auto safeBacklog = juce::uint64(storage->ring.getCapacity()) - fftSize;
+    if (writePosition - readPosition > safeBacklog)
+    {
+        const auto newReadPosition = writePosition - fftSize;
+        recordOverrun(newReadPosition - readPosition);
+        readPosition = newReadPosition;
+    }
+
+    if (! storage->readFrame(readPosition))
+    {
+        // Overwritten while we were copying: try again from the newest data next time.
+        // Otherwise nothing was lost, and the same frame is simply read again.
+        auto newReadPosition = readPosition;
+        if (storage->hasOverwritten(readPosition))
+        {
+            newReadPosition = storage->getWritePosition() - fftSize;
+            recordOverrun(newReadPosition - readPosition);
+        }
+        storage->readPosition.store(newReadPosition, std::memory_order_relaxed);
+        return;
+    }
+
+    storage->readPosition.store(readPosition + juce::uint64(storage->getHopSize()), std::memory_order_relaxed);
+    processFrame();
+}
+
+juce::uint64 AnalyserBase::getFrameGeneration() const noexcept
+{
+    return frameGeneration + (storage != nullptr ? storage->getFrameGeneration() : 0);
+}
+
+juce::uint64 AnalyserBase::getOverrunCount() const noexcept
+{
+    return overrunCount.load(std::memory_order_relaxed);
+}
+
+juce::uint64 AnalyserBase::getDroppedSampleCount() const noexcept
+{
+    return droppedSampleCount.load(std::memory_order_relaxed);
+}
+
+void AnalyserBase::recordOverrun(juce::uint64 numSamplesSkipped) noexcept
+{
+    overrunCount.fetch_add(1, std::memory_order_relaxed);
+    droppedSampleCount.fetch_add(numSamplesSkipped, std::memory_order_relaxed);
+}
+
+void AnalyserBase::handleAsyncUpdate()
+{
+    fifoSize = pendingFifoSize;
+    sampleRate = pendingSampleRate;
+
+    if (subscribers > 0)
+        allocateStorage();
+}
+
+void AnalyserBase::allocateStorage()
+{
+    if (fifoSize <= 0)
+        return;
+
+    scheduler->removeJob(this);
+    settingsChanged = false;
+    swapStorage(createStorage(fifoSize, sampleRate, getSettings(), *sharedTables));
+    scheduler->addJob(this);
+}
+
+void AnalyserBase::releaseStorage()
+{
+    scheduler->removeJob(this);
+    swapStorage(nullptr);
+}
+
+void AnalyserBase::swapStorage(std::unique_ptr<AnalyserStorage> newStorage)
+{
+    // Keep the generation counter monotonic across reallocations.
+    if (storage != nullptr)
+        frameGeneration += storage->getFrameGeneration();
+
+    {
+        // The audio thread must never see a half-swapped pointer, and the rings of a
+        // pair are swapped in at once, so they count positions from the same callback.
+        const juce::ScopedLock audioLocked(audioLock);
+        std::swap(storage, newStorage);
+    }
+    // The previous storage (if any) is freed here, outside of the lock.
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "AnalyserRing.h"
+#include "AnalyserSettings.h"
+#include "AnalysisScheduler.h"
+#include "EqualiserTables.h"
+
+/**
+ *  The rings a running analyser is fed through, and how far its worker has read them.
+ *
+ *  Both rings are allocated together and written in the same audio callback, so a given
+ *  absolute position refers to the same moment in both. Each kind of analyser derives its
+ *  storage from this, adding the worker's pipeline and the frames it publishes.
+ */
+struct AnalyserStorage
+{
+    AnalyserStorage(int audioFifoSize, double sampleRateToUse);
+    virtual ~AnalyserStorage() = default;
+
+    /** Replaces the pipeline after a settings change and updates frameSize. Worker thread only. */
+    virtual void rebuildPipeline(const AnalyserSettings& settings, EqualiserTables& tables) = 0;
+
+    /** Returns the number of samples from the start of one frame to the next. Worker thread only. */
+    virtual int getHopSize() const = 0;
+
+    /**
+     * Copies the frameSize samples from position on into the pipeline. Worker thread only.
+     *
+     * @return false if reading either ring failed.
+     */
+    virtual bool readFrame(juce::uint64 position) = 0;
+
+    /** Returns the number of frames published so far. */
+    virtual juce::uint64 getFrameGeneration() const noexcept = 0;
+
+    /**
+     * Both rings have published the samples below this position. A pair written in one
+     * pass publishes the first ring before the second, so never read beyond this.
+     */
+    juce::uint64 getWritePosition() const noexcept;
+
+    /** Returns true if the audio thread may have overwritten the sample at position in either ring. */
+    bool hasOverwritten(juce::uint64 position) const noexcept;
+
+    AnalyserRing ring;
+    AnalyserRing secondRing;
+    const double sampleRate;
+    std::atomic<juce::uint64> readPosition{ 0 };
+    /** The pipeline's FFT size, readable from the audio thread without touching the pipeline. */
+    std::atomic<int> frameSize{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AnalyserStorage)
+};
+
+/**
+ *  What the equaliser's analysers have in common.
+ *
+ *  An analyser costs nothing until a view subscribes to it: the first subscriber allocates
+ *  its storage and hands it to the shared AnalysisScheduler, and the last one to leave takes
+ *  it off again and frees it. New settings are picked up by the worker, which rebuilds its
+ *  own pipeline before the next frame. Every run of the job claims one frame from the rings,
+ *  skipping ahead if the audio thread has lapped the analysis, and hands it to processFrame().
+ *
+ *  Derived classes feed the rings on the audio thread and turn frames into something to draw.
+ */
+class AnalyserBase : public AnalysisScheduler::Job,
+                     private juce::AsyncUpdater
+{
+public:
+    ~AnalyserBase() override;
+
+    /**
+     * Sets the ring size and sample rate. Can be called from any thread; the storage is
+     * reallocated on the message thread, as that is the only thread allowed to swap it.
+     */
+    void setupAnalyser(int audioFifoSize, double sampleRateToUse);
+
+    /**
+     * Registers a view that wants to see this analyser's results.
+     *
+     * The first subscriber allocates the rings and pipeline and hands the analyser to the
+     * shared AnalysisScheduler; until then the analyser costs nothing on either the audio
+     * or the analysis side. Must be called on the message thread.
+     */
+    void addSubscriber();
+
+    /**
+     * Unregisters a view added with addSubscriber(). The last one to leave takes the
+     * analyser off the scheduler and frees its storage. Must be called on the message thread.
+     */
+    void removeSubscriber();
+
+    bool hasSubscribers() const noexcept;
+
+    /**
+     * Tells the analyser whether one of its subscribers has come on or gone off screen.
+     * Visible analysers are scheduled ahead of hidden ones. Must be called on the message thread.
+     */
+    void setSubscriberVisible(bool isVisible);
+
+    /**
+     * Changes the FFT size, overlap, window and averaging. Can be called from any thread
+     * without waiting on the analysis: the worker picks the new settings up before its
+     * next frame and rebuilds its own buffers, so nothing is reallocated under its feet.
+     */
+    void setSettings(const AnalyserSettings& newSettings);
+    AnalyserSettings getSettings() const;
+
+    bool isJobReady() const override;
+
+    /** Analyses a single frame. Called by the AnalysisScheduler's workers. */
+    void runJob() override;
+
+    /**
+     * Returns the number of frames published so far. Views compare this with the
+     * generation they last drew to decide whether to repaint. Message thread only.
+     */
+    juce::uint64 getFrameGeneration() const noexcept;
+
+    /** Returns how many times the analysis fell behind and had to skip audio. Safe from any thread. */
+    juce::uint64 getOverrunCount() const noexcept;
+
+    /** Returns the total number of samples skipped because the analysis fell behind. Safe from any thread. */
+    juce::uint64 getDroppedSampleCount() const noexcept;
+
+protected:
+    /**
+     * @param audioLockToUse Lock held by the audio thread while it feeds the analyser, so
+     *                       the storage can be swapped in and out safely.
+     */
+    explicit AnalyserBase(const juce::CriticalSection& audioLockToUse);
+
+    /** Creates the storage for the first subscriber or a new sample rate. Message thread only. */
+    virtual std::unique_ptr<AnalyserStorage> createStorage(int audioFifoSize, double sampleRate,
+                                                           const AnalyserSettings& settings, EqualiserTables& tables) = 0;
+
+    /** Processes the frame readFrame() has just copied and publishes the result. Worker thread only. */
+    virtual void processFrame() = 0;
+
+    /** Called on the thread calling setSettings() when the settings actually change. */
+    virtual void settingsChanging(const AnalyserSettings& newSettings) { juce::ignoreUnused(newSettings); }
+
+    /**
+     * Takes the analyser off the scheduler and frees its storage. Derived destructors must
+     * call this, so that no worker can still be inside their processFrame().
+     */
+    void stopAnalysis();
+
+    /** The storage, or nullptr while nothing subscribes. Audio thread, workers and message thread. */
+    AnalyserStorage* getStorage() const noexcept { return storage.get(); }
+
+    /** Flags the job to the workers once a whole frame is waiting. Wait-free; audio thread only. */
+    void notifyIfReady();
+
+private:
+    void recordOverrun(juce::uint64 numSamplesSkipped) noexcept;
+    void handleAsyncUpdate() override;
+    void allocateStorage();
+    void releaseStorage();
+    /** Message thread only, with the analyser off the scheduler. */
+    void swapStorage(std::unique_ptr<AnalyserStorage> newStorage);
+
+    const juce::CriticalSection& audioLock;
+    juce::SharedResourcePointer<EqualiserTables> sharedTables;
+    juce::SharedResourcePointer<AnalysisScheduler> scheduler;
+    std::unique_ptr<AnalyserStorage> storage;
+
+    std::atomic<double> pendingSampleRate{ 0.0 };
+    std::atomic<int> pendingFifoSize{ 0 };
+    double sampleRate = 0.0;
+    int fifoSize = 0;
+    juce::uint64 frameGeneration = 0;
+    int subscribers = 0;
+    int visibleSubscribers = 0;
+    juce::SpinLock settingsLock;
+    AnalyserSettings pendingSettings;
+    std::atomic<bool> settingsChanged{ false };
+    std::atomic<juce::uint64> overrunCount{ 0 };
+    std::atomic<juce::uint64> droppedSampleCount{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserBase)
+};
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ *  Single-writer ring of mono samples that never rejects or blocks the writer.
+ *
+ *  The audio thread always writes; when a reader falls behind, the oldest samples are
+ *  simply overwritten. Positions are absolute 64-bit sample counts, so any number of
+ *  readers can keep their own read position, and samples written at the same moment
+ *  into two rings share the same position.
+ *
+ *  Readers validate what they copied afterwards (in the manner of a sequence lock):
+ *  read() fails if the writer may have overwritten any part of the requested range
+ *  while it was being copied, and the reader then skips ahead.
+ */
+class AnalyserRing
+{
+public:
+    /** @param minimumCapacity Smallest number of samples to keep; rounded up to a power of two. */
+    explicit AnalyserRing(int minimumCapacity)
+        : _buffer(size_t(juce::nextPowerOfTwo(juce::jmax(2, minimumCapacity))), 0.0f),
+          _mask(juce::uint64(_buffer.size() - 1))
+    {
+    }
+
+    /** Returns the number of samples the ring holds. */
+    int getCapacity() const noexcept
+    {
+        return int(_buffer.size());
+    }
+
+    /**
+     * Writes the sum of some channels of a buffer. Audio thread only.
+     *
+     * Wait-free and bounded: at most one ring's worth of samples per channel is touched,
+     * however long the block is.
+     */
+    void write(const juce::AudioBuffer<float>& source, int startChannel, int numChannels)
+    {
+        const auto numSamples = source.getNumSamples();
+        if (numSamples <= 0 || numChannels <= 0)
+            return;
+
+        const auto region = beginWrite(numSamples);
+
+        for (int channel = startChannel; channel < startChannel + numChannels; ++channel)
+        {
+            const auto* samples = source.getReadPointer(channel, region.sourceOffset);
+
+            if (channel == startChannel)
+            {
+                juce::FloatVectorOperations::copy(_buffer.data() + region.index, samples, region.block1);
+                juce::FloatVectorOperations::copy(_buffer.data(), samples + region.block1, region.block2);
+            }
+            else
+            {
+                juce::FloatVectorOperations::add(_buffer.data() + region.index, samples, region.block1);
+                juce::FloatVectorOperations::add(_buffer.data(), samples + region.block1, region.block2);
+            }
+        }
+
+        endWrite(numSamples);
+    }
+
+    /**
+     * Writes a block produced by a callback in a single pass. Audio thread only.
+     *
+     * fill(dest, sourceIndex, count) is called once per contiguous segment (twice when the
+     * write wraps) and must write count samples, taken from the block from sourceIndex.
+     */
+    template<typename Fill>
+    void write(int numSamples, Fill&& fill)
+    {
+        if (numSamples <= 0)
+            return;
+
+        const auto region = beginWrite(numSamples);
+        fill(_buffer.data() + region.index, region.sourceOffset, region.block1);
+        if (region.block2 > 0)
+            fill(_buffer.data(), region.sourceOffset + region.block1, region.block2);
+        endWrite(numSamples);
+    }
+
+    /**
+     * Moves the positions on as if a block had been written, without touching the samples.
+     * Keeps a ring nobody is reading in step with its sibling for free. Audio thread only.
+     */
+    void skip(int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        beginWrite(numSamples);
+        endWrite(numSamples);
+    }
+
+    /**
+     * Writes two streams derived from the same block into two rings in a single pass.
+     * Audio thread only.
+     *
+     * The first ring publishes its block before the second, so readers of both must only
+     * go up to the lower of the two write positions.
+     *
+     * The rings must have the same capacity and write position. fill(first, second,
+     * sourceIndex, count) is called once per contiguous segment (twice when the write wraps)
+     * and must write count samples to both destinations, taken from the block from sourceIndex.
+     */
+    template<typename Fill>
+    static void writePair(AnalyserRing& firstRing, AnalyserRing& secondRing, int numSamples, Fill&& fill)
+    {
+        jassert(firstRing.getCapacity() == secondRing.getCapacity());
+        jassert(firstRing._writePosition.load() == secondRing._writePosition.load());
+
+        if (numSamples <= 0)
+            return;
+
+        const auto region = firstRing.beginWrite(numSamples);
+        secondRing.beginWrite(numSamples);
+
+        fill(firstRing._buffer.data() + region.index, secondRing._buffer.data() + region.index,
+             region.sourceOffset, region.block1);
+        if (region.block2 > 0)
+            fill(firstRing._buffer.data(), secondRing._buffer.data(),
+                 region.sourceOffset + region.block1, region.block2);
+
+        firstRing.endWrite(numSamples);
+        secondRing.endWrite(numSamples);
+    }
+
+    /** Returns the absolute position one past the last sample written. Safe from any thread. */
+    juce::uint64 getWritePosition() const noexcept
+    {
+        return _writePosition.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns true if the writer has claimed, and so may already have overwritten, the
+     * sample at an absolute position. Safe from any thread.
+     */
+    bool hasOverwritten(juce::uint64 position) const noexcept
+    {
+        return _writeClaim.load(std::memory_order_acquire) > position + juce::uint64(getCapacity());
+    }
+
+    /**
+     * Copies samples starting at an absolute position.
+     *
+     * @return false if any of the samples had already been, or may have been while copying,
+     *         overwritten by the writer; the contents of dest are then meaningless.
+     */
+    bool read(juce::uint64 position, float* dest, int numSamples) const
+    {
+        jassert(numSamples <= getCapacity());
+
+        if (position + juce::uint64(numSamples) > getWritePosition())
+            return false;
+
+        const auto index = int(position & _mask);
+        const auto block1 = juce::jmin(numSamples, getCapacity() - index);
+        juce::FloatVectorOperations::copy(dest, _buffer.data() + index, block1);
+        juce::FloatVectorOperations::copy(dest + block1, _buffer.data(), numSamples - block1);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return ! hasOverwritten(position);
+    }
+
+private:
+    /** Where a write of a block lands in the ring. */
+    struct Region
+    {
+        int index;          ///< Ring index of the first sample written.
+        int block1;         ///< Samples up to the end of the ring.
+        int block2;         ///< Samples wrapped round to the start.
+        int sourceOffset;   ///< Samples skipped at the start of the block.
+    };
+
+    /** Claims the region a block will occupy, so readers can tell it is being overwritten. */
+    Region beginWrite(int numSamples) noexcept
+    {
+        const auto position = _writePosition.load(std::memory_order_relaxed);
+
+        // A block longer than the ring can only leave its tail behind anyway.
+        const auto numToWrite = juce::jmin(numSamples, getCapacity());
+        const auto sourceOffset = numSamples - numToWrite;
+        const auto start = position + juce::uint64(sourceOffset);
+
+        _writeClaim.store(start + juce::uint64(numToWrite), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const auto index = int(start & _mask);
+        const auto block1 = juce::jmin(numToWrite, getCapacity() - index);
+        return { index, block1, numToWrite - block1, sourceOffset };
+    }
+
+    /** Publishes a block written after beginWrite(). */
+    void endWrite(int numSamples) noexcept
+    {
+        const auto position = _writePosition.load(std::memory_order_relaxed);
+        _writePosition.store(position + juce::uint64(numSamples), std::memory_order_release);
+    }
+
+    std::vector<float> _buffer;
+    const juce::uint64 _mask;
+    std::atomic<juce::uint64> _writePosition{ 0 };
+    std::atomic<juce::uint64> _writeClaim{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(AnalyserRing)
+};
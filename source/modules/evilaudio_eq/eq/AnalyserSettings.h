@@ -0,0 +1,95 @@
+#pragma once
+
+#include "juce_dsp/juce_dsp.h"
+
+/**
+ *  Runtime configuration of the equaliser's STFT analysers.
+ *
+ *  Fine resolution (large FFTs, heavy overlap) suits mastering, while small FFTs with
+ *  little overlap keep tracking sessions cheap. Whatever is chosen, the number of frames
+ *  analysed per second is capped, so the analysis cost stays bounded at any sample rate.
+ */
+struct AnalyserSettings
+{
+    /** How successive spectrum frames are combined into the displayed spectrum. */
+    enum class Averaging
+    {
+        boxcar = 0,     ///< Mean of the last boxcarFrames frames.
+        exponential,    ///< Exponential moving average with the given time constant.
+        peakHold        ///< Highest value seen, falling at peakDecayDbPerSecond.
+    };
+
+    /** Which channels are analysed, and how. */
+    enum class ChannelMode
+    {
+        mono = 0,       ///< Sum of all channels.
+        left,
+        right,
+        leftRight,      ///< Left and right as two overlaid spectra.
+        midSide         ///< Mid (L + R) / 2 and side (L - R) / 2 as two overlaid spectra.
+    };
+
+    using WindowingMethod = juce::dsp::WindowingFunction<float>::WindowingMethod;
+
+    static constexpr int minFftOrder = 10;
+    static constexpr int maxFftOrder = 15;
+    /** Upper bound on frames per second; larger hops are forced at high sample rates. */
+    static constexpr int maxFramesPerSecond = 60;
+    /** Longest boxcar average; each frame of history costs a spectrum's worth of memory. */
+    static constexpr int maxBoxcarFrames = 64;
+    /** Fastest peak-hold fall; a negative rate would make the held peaks grow instead. */
+    static constexpr float maxPeakDecayDbPerSecond = 120.0f;
+    /** Finest smoothing the analyser menu offers, 1/24 octave. */
+    static constexpr int maxOctaveFraction = 24;
+
+    int fftOrder = 12;
+    /** Fraction of each frame shared with the next, 0 to 0.875. Determines the hop size. */
+    float overlap = 0.5f;
+    WindowingMethod window = juce::dsp::WindowingFunction<float>::hann;
+    Averaging averaging = Averaging::boxcar;
+    int boxcarFrames = 4;
+    float averagingTimeSeconds = 0.3f;
+    float peakDecayDbPerSecond = 12.0f;
+    /** Smooths the displayed spectrum over 1/N octave; 0 leaves it unsmoothed. */
+    int octaveFraction = 0;
+    ChannelMode channelMode = ChannelMode::mono;
+
+    int getFftSize() const noexcept
+    {
+        return 1 << juce::jlimit(minFftOrder, maxFftOrder, fftOrder);
+    }
+
+    /** Returns 2 for the modes that overlay two spectra, 1 otherwise. */
+    int getNumStreams() const noexcept
+    {
+        return channelMode == ChannelMode::leftRight || channelMode == ChannelMode::midSide ? 2 : 1;
+    }
+
+    /** Returns the hop between frames, taking the frame rate cap into account. */
+    int getHopSize(double sampleRate) const noexcept
+    {
+        const auto fftSize = getFftSize();
+        const auto requested = juce::roundToInt(fftSize * (1.0f - juce::jlimit(0.0f, 0.875f, overlap)));
+        const auto minimum = sampleRate > 0.0 ? int(std::ceil(sampleRate / maxFramesPerSecond)) : 1;
+        // The hop may exceed the FFT size; the samples in between are simply not analysed.
+        return juce::jmax(1, requested, minimum);
+    }
+
+    bool operator==(const AnalyserSettings& other) const noexcept
+    {
+        return fftOrder == other.fftOrder
+            && overlap == other.overlap
+            && window == other.window
+            && averaging == other.averaging
+            && boxcarFrames == other.boxcarFrames
+            && averagingTimeSeconds == other.averagingTimeSeconds
+            && peakDecayDbPerSecond == other.peakDecayDbPerSecond
+            && octaveFraction == other.octaveFraction
+            && channelMode == other.channelMode;
+    }
+
+    bool operator!=(const AnalyserSettings& other) const noexcept
+    {
+        return !operator==(other);
+    }
+};
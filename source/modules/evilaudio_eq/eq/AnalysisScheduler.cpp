@@ -0,0 +1,157 @@
+#include "AnalysisScheduler.h"
+
+class AnalysisScheduler::Worker : public juce::Thread
+{
+public:
+    Worker(AnalysisScheduler& scheduler, int index)
+        : juce::Thread("Equaliser-Analysis-" + juce::String(index)),
+          _scheduler(scheduler)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (auto* job = _scheduler.claimNextJob())
+            {
+                job->runJob();
+                _scheduler.releaseJob(job);
+            }
+            else
+            {
+                // Nothing is ready; sleep until an analyser delivers more audio.
+                _scheduler.waitForWork(*this);
+            }
+        }
+    }
+
+private:
+    AnalysisScheduler& _scheduler;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+
+AnalysisScheduler::AnalysisScheduler()
+{
+    // Leave headroom for the audio and message threads; analysis never needs more than a few cores.
+    const auto numWorkers = juce::jlimit(1, 4, juce::SystemStats::getNumCpus() / 2);
+
+    for (int i = 0; i < numWorkers; ++i)
+        _workers.add(new Worker(*this, i))->startThread(juce::Thread::Priority::low);
+}
+
+AnalysisScheduler::~AnalysisScheduler()
+{
+    for (auto* worker : _workers)
+        worker->signalThreadShouldExit();
+
+    // Every waiting worker needs its own wake-up.
+    for (int i = 0; i < _workers.size(); ++i)
+        _workAvailable.signal();
+
+    for (auto* worker : _workers)
+        worker->stopThread(2000);
+
+    jassert(_jobs.empty());
+}
+
+void AnalysisScheduler::addJob(Job* job)
+{
+    jassert(job != nullptr);
+    {
+        const juce::ScopedLock sl(_jobsLock);
+        jassert(std::find(_jobs.begin(), _jobs.end(), job) == _jobs.end());
+        _jobs.push_back(job);
+    }
+    notify();
+}
+
+void AnalysisScheduler::removeJob(Job* job)
+{
+    {
+        const juce::ScopedLock sl(_jobsLock);
+        auto it = std::find(_jobs.begin(), _jobs.end(), job);
+        if (it == _jobs.end())
+            return;
+
+        _jobs.erase(it);
+    }
+
+    // Jobs are only claimed while they are in the list, so once a running worker hands
+    // this one back nobody can pick it up again.
+    while (job->_running.load())
+        juce::Thread::yield();
+}
+
+void AnalysisScheduler::notify()
+{
+    _workAvailable.signal();
+}
+
+void AnalysisScheduler::notifyJobReady() noexcept
+{
+    _workPending.store(true, std::memory_order_release);
+}
+
+void AnalysisScheduler::waitForWork(const juce::Thread& worker)
+{
+    // The audio thread never signals the event, so poll its flag in short waits. The long
+    // timeout only guards against a missed wake-up, it isn't needed for progress.
+    for (auto waited = 0; waited < 500 && ! worker.threadShouldExit(); waited += pollIntervalMs)
+    {
+        if (_workPending.load(std::memory_order_relaxed) && _workPending.exchange(false, std::memory_order_acquire))
+            return;
+
+        if (_workAvailable.wait(pollIntervalMs))
+            return;
+    }
+}
+
+int AnalysisScheduler::getNumWorkers() const noexcept
+{
+    return _workers.size();
+}
+
+AnalysisScheduler::Job* AnalysisScheduler::claimNextJob()
+{
+    const juce::ScopedLock sl(_jobsLock);
+
+    const auto numJobs = _jobs.size();
+    if (numJobs == 0)
+        return nullptr;
+
+    // Two round-robin passes from the cursor: visible jobs first, then everything else.
+    for (auto visibleOnly : { true, false })
+    {
+        for (size_t i = 0; i < numJobs; ++i)
+        {
+            const auto index = (_nextJob + i) % numJobs;
+            auto* job = _jobs[index];
+
+            if (visibleOnly && !job->isJobVisible())
+                continue;
+
+            if (job->_running.load() || !job->isJobReady())
+                continue;
+
+            job->_running = true;
+            _nextJob = index + 1;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void AnalysisScheduler::releaseJob(Job* job)
+{
+    // The job may have more work queued up; let another worker have a look while this
+    // one moves on. Check before handing the job back, as removeJob() may delete it after.
+    const auto stillReady = job->isJobReady();
+    job->_running = false;
+
+    if (stillReady)
+        notify();
+}
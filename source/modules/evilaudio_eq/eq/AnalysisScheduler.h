@@ -0,0 +1,97 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ *  Process-wide pool of worker threads that runs spectrum analysis for every
+ *  equaliser instance.
+ *
+ *  Analysers register themselves as Jobs. Workers hand out one unit of work at a time
+ *  (typically a single FFT frame) in round-robin order, so no job can starve the others,
+ *  and jobs whose views are currently visible are always served first. The pool size is
+ *  bounded by the number of CPUs rather than the number of plugin instances.
+ *
+ *  Hold the scheduler through a juce::SharedResourcePointer; the workers are started
+ *  by the first holder and stopped when the last one goes away.
+ */
+class AnalysisScheduler
+{
+public:
+    /** A unit of schedulable analysis work. */
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+
+        /**
+         * Returns true if runJob() has something to do right now.
+         *
+         * Called on worker threads while the scheduler's job list is locked, so it must
+         * be cheap and must not call back into the scheduler.
+         */
+        virtual bool isJobReady() const = 0;
+
+        /** Performs one unit of work. Never called concurrently for the same job. */
+        virtual void runJob() = 0;
+
+        /** Visible jobs are scheduled ahead of hidden ones. Safe to call from any thread. */
+        void setJobVisible(bool shouldBeVisible) noexcept   { _visible = shouldBeVisible; }
+        bool isJobVisible() const noexcept                  { return _visible; }
+
+    private:
+        friend class AnalysisScheduler;
+
+        std::atomic<bool> _visible{ false };
+        std::atomic<bool> _running{ false };
+    };
+
+    AnalysisScheduler();
+    ~AnalysisScheduler();
+
+    /** Starts scheduling a job. */
+    void addJob(Job* job);
+
+    /**
+     * Stops scheduling a job, waiting for any worker that is currently running it to
+     * finish first. Once this returns the job can safely be modified or deleted.
+     */
+    void removeJob(Job* job);
+
+    /**
+     * Wakes a worker because a job may have become ready. Signalling takes a short lock,
+     * so don't call this from the audio thread; use notifyJobReady() there.
+     */
+    void notify();
+
+    /**
+     * Tells the workers that a job has just become ready. Wait-free, for the audio thread.
+     *
+     * This only raises a flag. Idle workers check it every pollIntervalMs, so the job is
+     * picked up within a fraction of a frame without the audio thread touching a lock.
+     */
+    void notifyJobReady() noexcept;
+
+    /** How often idle workers look for work flagged by notifyJobReady(). */
+    static constexpr int pollIntervalMs = 2;
+
+    /** Returns the number of worker threads in the pool. */
+    int getNumWorkers() const noexcept;
+
+private:
+    class Worker;
+
+    Job* claimNextJob();
+    void releaseJob(Job* job);
+    /** Blocks an idle worker until it is signalled, work is flagged or the long timeout passes. */
+    void waitForWork(const juce::Thread& worker);
+
+    juce::CriticalSection _jobsLock;
+    std::vector<Job*> _jobs;
+    size_t _nextJob = 0;
+
+    juce::WaitableEvent _workAvailable;
+    std::atomic<bool> _workPending{ false };
+    juce::OwnedArray<Worker> _workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisScheduler)
+};
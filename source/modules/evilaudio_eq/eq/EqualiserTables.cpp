@@ -0,0 +1,14 @@
+#include "EqualiserTables.h"
+
+const std::vector<float>& EqualiserTables::getWindowTable(size_t size, WindowingMethod method)
+{
+    const juce::ScopedLock sl(_lock);
+
+    auto& table = _windowTables[{ size, int(method) }];
+    if (table.size() != size)
+    {
+        table.resize(size);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(table.data(), size, method, true);
+    }
+    return table;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "juce_dsp/juce_dsp.h"
+
+#include <map>
+
+/**
+ *  Process-wide cache of read-only tables shared by every equaliser instance.
+ *
+ *  Window functions only depend on their size and type, so they are built once on first
+ *  request and handed out by const reference to every analyser. Hold the cache through a
+ *  juce::SharedResourcePointer; the returned references stay valid for as long as that
+ *  pointer is alive.
+ */
+class EqualiserTables
+{
+public:
+    /// Window type used by the analysers.
+    using WindowingMethod = juce::dsp::WindowingFunction<float>::WindowingMethod;
+
+    EqualiserTables() = default;
+
+    /**
+     * Returns a normalised window table of the given size and type.
+     *
+     * @param size   Number of samples in the window.
+     * @param method Windowing function to tabulate.
+     */
+    const std::vector<float>& getWindowTable(size_t size, WindowingMethod method);
+
+private:
+    juce::CriticalSection _lock;
+    std::map<std::pair<size_t, int>, std::vector<float>> _windowTables;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqualiserTables)
+};
@@ -0,0 +1,304 @@
+#include "FftBackend.h"
+
+namespace
+{
+    /** Wraps juce::dsp::FFT, which uses IPP, FFTW or Accelerate where JUCE was built with them. */
+    class JuceFftBackend final : public FftBackend
+    {
+    public:
+        explicit JuceFftBackend(int order)
+            : FftBackend(order),
+              _fft(order),
+              _work(size_t(_size * 2), 0.0f)
+        {
+        }
+
+        juce::String getName() const override
+        {
+            return "JUCE";
+        }
+
+        void performRealForward(const float* input, std::complex<float>* output) noexcept override
+        {
+            std::copy(input, input + _size, _work.begin());
+            _fft.performRealOnlyForwardTransform(_work.data(), true);
+            std::copy(_work.begin(), _work.begin() + _size + 2, reinterpret_cast<float*>(output));
+        }
+
+        void performMagnitudes(const float* input, float* magnitudes) noexcept override
+        {
+            std::copy(input, input + _size, _work.begin());
+            _fft.performFrequencyOnlyForwardTransform(_work.data(), true);
+            std::copy(_work.begin(), _work.begin() + _size / 2, magnitudes);
+        }
+
+    private:
+        juce::dsp::FFT _fft;
+        std::vector<float> _work;
+    };
+
+    //==============================================================================
+
+    /**
+     *  Real FFT computed as a half-size complex FFT followed by a split step.
+     *
+     *  The complex FFT is a Stockham autosort (no bit reversal pass) built from radix-4
+     *  stages, plus one radix-2 stage for odd orders. Real and imaginary parts are kept in
+     *  separate arrays and every inner loop walks contiguous memory with no branches or
+     *  aliasing, so compilers vectorise them for whatever SIMD width the target has.
+     */
+    class BuiltInFftBackend final : public FftBackend
+    {
+    public:
+        explicit BuiltInFftBackend(int order)
+            : FftBackend(order),
+              _half(_size / 2)
+        {
+            jassert(order >= 1);
+
+            for (auto* buffer : { &_re, &_im, &_tempRe, &_tempIm, &_outRe, &_outIm })
+                buffer->assign(size_t(_half), 0.0f);
+
+            const auto twoPi = juce::MathConstants<double>::twoPi;
+
+            // Twiddles for each radix-4 stage, w^k_p = e^(-2 pi i k p / n) for k = 1, 2, 3.
+            for (int n = _half; n >= 4; n /= 4)
+            {
+                const auto quarter = n / 4;
+                Stage stage;
+                stage.length = n;
+                stage.twiddles.resize(size_t(quarter * 6));
+
+                for (int p = 0; p < quarter; ++p)
+                {
+                    for (int k = 1; k <= 3; ++k)
+                    {
+                        const auto angle = -twoPi * k * p / n;
+                        stage.twiddles[size_t((k - 1) * 2 * quarter + p)] = float(std::cos(angle));
+                        stage.twiddles[size_t(((k - 1) * 2 + 1) * quarter + p)] = float(std::sin(angle));
+                    }
+                }
+                _stages.push_back(std::move(stage));
+            }
+
+            // Twiddles for the final real split, e^(-2 pi i k / N).
+            _splitRe.resize(size_t(_half));
+            _splitIm.resize(size_t(_half));
+            for (int k = 0; k < _half; ++k)
+            {
+                _splitRe[size_t(k)] = float(std::cos(-twoPi * k / _size));
+                _splitIm[size_t(k)] = float(std::sin(-twoPi * k / _size));
+            }
+        }
+
+        juce::String getName() const override
+        {
+            return "Built-in radix-4";
+        }
+
+        void performRealForward(const float* input, std::complex<float>* output) noexcept override
+        {
+            const auto dc = transform(input);
+
+            output[0] = { dc.first, 0.0f };
+            output[_half] = { dc.second, 0.0f };
+            for (int k = 1; k < _half; ++k)
+                output[k] = { _outRe[size_t(k)], _outIm[size_t(k)] };
+        }
+
+        void performMagnitudes(const float* input, float* magnitudes) noexcept override
+        {
+            const auto dc = transform(input);
+
+            const auto* __restrict re = _outRe.data();
+            const auto* __restrict im = _outIm.data();
+
+            magnitudes[0] = std::abs(dc.first);
+            for (int k = 1; k < _half; ++k)
+                magnitudes[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+        }
+
+    private:
+        struct Stage
+        {
+            int length = 0;
+            /** w1 re, w1 im, w2 re, w2 im, w3 re, w3 im; length / 4 values each. */
+            std::vector<float> twiddles;
+        };
+
+        /**
+         * Runs the whole transform, leaving bins 1 to N/2 - 1 in _outRe/_outIm.
+         * @return the (purely real) DC and Nyquist bins.
+         */
+        std::pair<float, float> transform(const float* input) noexcept
+        {
+            // Pack even samples as real and odd samples as imaginary parts.
+            {
+                auto* __restrict re = _re.data();
+                auto* __restrict im = _im.data();
+                for (int k = 0; k < _half; ++k)
+                {
+                    re[k] = input[2 * k];
+                    im[k] = input[2 * k + 1];
+                }
+            }
+
+            float* xr = _re.data();
+            float* xi = _im.data();
+            float* yr = _tempRe.data();
+            float* yi = _tempIm.data();
+
+            int stride = 1;
+            for (const auto& stage : _stages)
+            {
+                radix4(stage, stride, xr, xi, yr, yi);
+                std::swap(xr, yr);
+                std::swap(xi, yi);
+                stride *= 4;
+            }
+
+            if (stride < _half)
+            {
+                radix2(stride, xr, xi, yr, yi);
+                std::swap(xr, yr);
+                std::swap(xi, yi);
+            }
+
+            split(xr, xi);
+            return { xr[0] + xi[0], xr[0] - xi[0] };
+        }
+
+        void radix4(const Stage& stage, int stride, const float* xr, const float* xi, float* yr, float* yi) noexcept
+        {
+            const auto quarter = stage.length / 4;
+            const auto* w1r = stage.twiddles.data();
+            const auto* w1i = w1r + quarter;
+            const auto* w2r = w1i + quarter;
+            const auto* w2i = w2r + quarter;
+            const auto* w3r = w2i + quarter;
+            const auto* w3i = w3r + quarter;
+
+            if (stride == 1)
+            {
+                // First stage: vectorise across butterflies.
+                butterflies<true>(quarter, quarter, 1, xr, xi, yr, yi, w1r, w1i, w2r, w2i, w3r, w3i);
+                return;
+            }
+
+            // Later stages: each twiddle is shared by `stride` contiguous butterflies.
+            for (int p = 0; p < quarter; ++p)
+                butterflies<false>(stride, quarter * stride, stride, xr + p * stride, xi + p * stride,
+                            yr + 4 * p * stride, yi + 4 * p * stride,
+                            w1r + p, w1i + p, w2r + p, w2i + p, w3r + p, w3i + p);
+        }
+
+        /**
+         * Runs count butterflies, the j-th reading x[j + k * inputGap] and writing
+         * y[j * outputStep + k * outputGap] for k = 0..3. In the first stage every butterfly
+         * has its own twiddles and outputStep is 4; in later ones they share twiddle [0] and
+         * outputStep is 1. Keeping that a compile-time choice lets both loops vectorise.
+         */
+        template<bool firstStage>
+        static void butterflies(int count, int inputGap, int outputGap,
+                                const float* __restrict xr, const float* __restrict xi,
+                                float* __restrict yr, float* __restrict yi,
+                                const float* w1r, const float* w1i, const float* w2r,
+                                const float* w2i, const float* w3r, const float* w3i) noexcept
+        {
+            for (int j = 0; j < count; ++j)
+            {
+                const auto in = j;
+                const auto out = firstStage ? j * 4 : j;
+                const auto t = firstStage ? j : 0;
+
+                const auto ar = xr[in],                ai = xi[in];
+                const auto br = xr[in + inputGap],     bi = xi[in + inputGap];
+                const auto cr = xr[in + 2 * inputGap], ci = xi[in + 2 * inputGap];
+                const auto dr = xr[in + 3 * inputGap], di = xi[in + 3 * inputGap];
+
+                const auto apcR = ar + cr, apcI = ai + ci;
+                const auto amcR = ar - cr, amcI = ai - ci;
+                const auto bpdR = br + dr, bpdI = bi + di;
+                const auto bmdR = br - dr, bmdI = bi - di;
+
+                yr[out] = apcR + bpdR;
+                yi[out] = apcI + bpdI;
+
+                // (a - c) - i (b - d)
+                const auto t1R = amcR + bmdI, t1I = amcI - bmdR;
+                yr[out + outputGap] = t1R * w1r[t] - t1I * w1i[t];
+                yi[out + outputGap] = t1R * w1i[t] + t1I * w1r[t];
+
+                const auto t2R = apcR - bpdR, t2I = apcI - bpdI;
+                yr[out + 2 * outputGap] = t2R * w2r[t] - t2I * w2i[t];
+                yi[out + 2 * outputGap] = t2R * w2i[t] + t2I * w2r[t];
+
+                // (a - c) + i (b - d)
+                const auto t3R = amcR - bmdI, t3I = amcI + bmdR;
+                yr[out + 3 * outputGap] = t3R * w3r[t] - t3I * w3i[t];
+                yi[out + 3 * outputGap] = t3R * w3i[t] + t3I * w3r[t];
+            }
+        }
+
+        /** The last stage of an odd order, where the sub-transforms are only two points long. */
+        static void radix2(int stride, const float* __restrict xr, const float* __restrict xi,
+                           float* __restrict yr, float* __restrict yi) noexcept
+        {
+            for (int q = 0; q < stride; ++q)
+            {
+                yr[q] = xr[q] + xr[q + stride];
+                yi[q] = xi[q] + xi[q + stride];
+                yr[q + stride] = xr[q] - xr[q + stride];
+                yi[q + stride] = xi[q] - xi[q + stride];
+            }
+        }
+
+        /** Separates the spectra of the even and odd samples and combines them into the real FFT. */
+        void split(const float* __restrict zr, const float* __restrict zi) noexcept
+        {
+            auto* __restrict outRe = _outRe.data();
+            auto* __restrict outIm = _outIm.data();
+            const auto* __restrict wr = _splitRe.data();
+            const auto* __restrict wi = _splitIm.data();
+
+            for (int k = 1; k < _half; ++k)
+            {
+                // E = (Z[k] + conj Z[M-k]) / 2, O = (Z[k] - conj Z[M-k]) / 2, X = E - i w^k O
+                const auto cr = zr[_half - k], ci = -zi[_half - k];
+                const auto er = 0.5f * (zr[k] + cr), ei = 0.5f * (zi[k] + ci);
+                const auto dr = 0.5f * (zr[k] - cr), di = 0.5f * (zi[k] - ci);
+                const auto tr = wr[k] * dr - wi[k] * di;
+                const auto ti = wr[k] * di + wi[k] * dr;
+                outRe[k] = er + ti;
+                outIm[k] = ei - tr;
+            }
+        }
+
+        const int _half;
+        std::vector<Stage> _stages;
+        std::vector<float> _re, _im, _tempRe, _tempIm, _outRe, _outIm;
+        std::vector<float> _splitRe, _splitIm;
+    };
+}
+
+//==============================================================================
+
+std::unique_ptr<FftBackend> FftBackend::create(int order, Type type)
+{
+    if (type == Type::preferred)
+        type = isJuceNative() ? Type::juce : Type::builtIn;
+
+    if (type == Type::juce)
+        return std::make_unique<JuceFftBackend>(order);
+
+    return std::make_unique<BuiltInFftBackend>(order);
+}
+
+bool FftBackend::isJuceNative() noexcept
+{
+   #if JUCE_MAC || JUCE_IOS || JUCE_DSP_USE_INTEL_MKL || JUCE_DSP_USE_SHARED_FFTW || JUCE_DSP_USE_STATIC_FFTW
+    return true;
+   #else
+    return false;
+   #endif
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "juce_dsp/juce_dsp.h"
+#include <complex>
+
+/**
+ *  A forward real-input FFT of a fixed power-of-two size.
+ *
+ *  juce::dsp::FFT is fast when JUCE is built against IPP, FFTW or Accelerate, but falls back
+ *  to a generic scalar implementation everywhere else, including a stock Linux build. The
+ *  analysers (and anything else in the module that needs a spectrum) go through this
+ *  interface instead, so they get the best engine available on the platform.
+ *
+ *  Instances keep their own scratch memory and are not thread safe; give every thread its own.
+ */
+class FftBackend
+{
+public:
+    enum class Type
+    {
+        preferred = 0,  ///< JUCE when it has a native engine, the built-in one otherwise.
+        juce,           ///< juce::dsp::FFT.
+        builtIn         ///< The module's own split-format radix-4 FFT.
+    };
+
+    virtual ~FftBackend() = default;
+
+    /** Creates a backend for 2^order points. */
+    static std::unique_ptr<FftBackend> create(int order, Type type = Type::preferred);
+
+    /** Returns true if juce::dsp::FFT is backed by a platform FFT library in this build. */
+    static bool isJuceNative() noexcept;
+
+    virtual juce::String getName() const = 0;
+
+    int getSize() const noexcept { return _size; }
+
+    /**
+     * Transforms getSize() real samples into the getSize() / 2 + 1 complex bins from DC
+     * to Nyquist inclusive. Unnormalised, with the usual e^(-i...) sign convention.
+     */
+    virtual void performRealForward(const float* input, std::complex<float>* output) noexcept = 0;
+
+    /** Writes the magnitudes of the getSize() / 2 bins below Nyquist. */
+    virtual void performMagnitudes(const float* input, float* magnitudes) noexcept = 0;
+
+protected:
+    explicit FftBackend(int order)
+        : _order(order),
+          _size(1 << order)
+    {
+    }
+
+    const int _order;
+    const int _size;
+
+    JUCE_DECLARE_NON_COPYABLE(FftBackend)
+};
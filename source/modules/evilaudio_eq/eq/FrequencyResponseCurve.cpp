@@ -0,0 +1,163 @@
+#include "FrequencyResponseCurve.h"
+
+void FrequencyResponseCurve::setGrid(int numColumns, double sampleRate, float minFrequency, float numOctaves)
+{
+    if (numColumns == _numColumns && sampleRate == _sampleRate
+        && minFrequency == _minFrequency && numOctaves == _numOctaves)
+        return;
+
+    _numColumns = numColumns;
+    _sampleRate = sampleRate;
+    _minFrequency = minFrequency;
+    _numOctaves = numOctaves;
+    _columns.clear();
+
+    if (numColumns <= 0 || sampleRate <= 0.0)
+        return;
+
+    // One point at the centre of every column up to Nyquist.
+    _columns.reserve(size_t(numColumns));
+    for (int c = 0; c < numColumns; ++c)
+    {
+        const auto frequency = minFrequency * std::pow(2.0, numOctaves * (c + 0.5) / numColumns);
+        if (frequency >= 0.5 * sampleRate)
+            break;
+
+        const auto halfAngle = juce::MathConstants<double>::pi * frequency / sampleRate;
+        _columns.push_back({ c + 0.5, juce::square(std::sin(halfAngle)) });
+    }
+}
+
+void FrequencyResponseCurve::getMagnitudesSquared(const Coefficients& filter, const double* phi, double* dest, int numPoints) noexcept
+{
+    // The coefficients are normalised so a0 = 1 and stored as b0 b1 [b2] a1 [a2].
+    const auto* raw = filter.coefficients.begin();
+    const auto order = filter.getFilterOrder();
+
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    if (order == 1)
+    {
+        b0 = raw[0]; b1 = raw[1]; a1 = raw[2];
+    }
+    else if (order == 2)
+    {
+        b0 = raw[0]; b1 = raw[1]; b2 = raw[2]; a1 = raw[3]; a2 = raw[4];
+    }
+
+    // |b0 + b1 z^-1 + b2 z^-2|^2 on the unit circle, as a quadratic in phi = sin^2(w / 2).
+    const auto n0 = juce::square(b0 + b1 + b2);
+    const auto n1 = -4.0 * (b0 * b1 + 4.0 * b0 * b2 + b1 * b2);
+    const auto n2 = 16.0 * b0 * b2;
+    const auto d0 = juce::square(1.0 + a1 + a2);
+    const auto d1 = -4.0 * (a1 + 4.0 * a2 + a1 * a2);
+    const auto d2 = 16.0 * a2;
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const auto p = phi[i];
+        const auto numerator = n0 + p * (n1 + p * n2);
+        const auto denominator = d0 + p * (d1 + p * d2);
+        dest[i] = numerator / denominator;
+    }
+}
+
+void FrequencyResponseCurve::addPoint(double w)
+{
+    if (w <= 0.0 || w >= juce::MathConstants<double>::pi)
+        return;
+
+    const auto frequency = w * _sampleRate / juce::MathConstants<double>::twoPi;
+    const auto x = _numColumns * std::log2(frequency / _minFrequency) / _numOctaves;
+    if (x >= 0.0 && x < _numColumns)
+        _extraPoints.push_back({ x, juce::square(std::sin(0.5 * w)) });
+}
+
+void FrequencyResponseCurve::addResonancePoints(const Coefficients& filter)
+{
+    if (filter.getFilterOrder() != 2)
+        return;
+
+    const auto* raw = filter.coefficients.begin();
+    const double b0 = raw[0], b1 = raw[1], b2 = raw[2], a1 = raw[3], a2 = raw[4];
+
+    // Roughly one column, in radians, at the top of the plot; resonances wider than a few
+    // of these are resolved by the column grid anyway.
+    const auto columnWidth = juce::MathConstants<double>::twoPi * 0.5 * (std::exp2(double(_numOctaves) / _numColumns) - 1.0);
+
+    // A pair of complex roots r e^(+-j theta) of 1 + c1 z^-1 + c2 z^-2 gives a peak (poles)
+    // or a dip (zeros) at theta about (1 - r) wide.
+    const auto addRoots = [&](double c1, double c2)
+    {
+        if (c2 <= 0.0 || c1 * c1 >= 4.0 * c2)
+            return;
+
+        const auto radius = std::sqrt(c2);
+        const auto theta = std::acos(juce::jlimit(-1.0, 1.0, -c1 / (2.0 * radius)));
+        const auto width = std::abs(1.0 - radius);
+
+        addPoint(theta);
+        if (width < 4.0 * columnWidth)
+            for (auto offset : { 0.25, 0.5, 1.0, 2.0 })
+            {
+                addPoint(theta - offset * width);
+                addPoint(theta + offset * width);
+            }
+    };
+
+    addRoots(a1, a2);
+    if (b0 != 0.0)
+        addRoots(b1 / b0, b2 / b0);
+}
+
+void FrequencyResponseCurve::createPath(juce::Path& path, const std::vector<Coefficients::Ptr>& filters, double gain,
+                                        juce::Rectangle<float> bounds, float maxDecibels)
+{
+    path.clear();
+    if (_columns.empty())
+        return;
+
+    // The column grid, merged with the extra points around each filter's resonances.
+    _extraPoints.clear();
+    for (const auto& filter : filters)
+        if (filter != nullptr)
+            addResonancePoints(*filter);
+
+    std::sort(_extraPoints.begin(), _extraPoints.end(), [](const Point& a, const Point& b) { return a.x < b.x; });
+    _points.resize(_columns.size() + _extraPoints.size());
+    std::merge(_columns.begin(), _columns.end(), _extraPoints.begin(), _extraPoints.end(), _points.begin(),
+               [](const Point& a, const Point& b) { return a.x < b.x; });
+
+    const auto numPoints = int(_points.size());
+    _phi.resize(_points.size());
+    _product.resize(_points.size());
+    _scratch.resize(_points.size());
+
+    for (size_t i = 0; i < _points.size(); ++i)
+        _phi[i] = _points[i].phi;
+
+    std::fill(_product.begin(), _product.end(), gain * gain);
+    for (const auto& filter : filters)
+    {
+        if (filter == nullptr)
+            continue;
+
+        getMagnitudesSquared(*filter, _phi.data(), _scratch.data(), numPoints);
+        juce::FloatVectorOperations::multiply(_product.data(), _scratch.data(), numPoints);
+    }
+
+    // 10 log10 of the squared magnitude is the level in decibels.
+    const auto minPower = std::pow(10.0, -maxDecibels / 10.0);
+    path.preallocateSpace(numPoints * 3 + 8);
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const auto decibels = float(10.0 * std::log10(juce::jmax(_product[size_t(i)], minPower)));
+        const auto x = bounds.getX() + float(_points[size_t(i)].x);
+        const auto y = juce::jmap(decibels, -maxDecibels, maxDecibels, bounds.getBottom(), bounds.getY());
+
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+}
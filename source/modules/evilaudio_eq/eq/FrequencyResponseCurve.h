@@ -0,0 +1,77 @@
+#pragma once
+
+#include "juce_dsp/juce_dsp.h"
+
+/**
+ *  Builds paths through the magnitude response of first and second order IIR sections
+ *  on a log-frequency plot, at the resolution of the plot.
+ *
+ *  The response is evaluated once per pixel column, plus a few extra points around every
+ *  resonance (a pair of complex poles or zeros) that is narrower than the column grid
+ *  would resolve, so high-Q peaks and notches keep their true height and depth.
+ *
+ *  Each section's squared magnitude is evaluated as a ratio of two quadratics in
+ *  phi = sin^2(w / 2), which needs no trigonometry or complex arithmetic per point and
+ *  stays accurate at low frequencies, where the usual polynomial in cos(w) cancels. The
+ *  inner loop is branch-free and vectorises.
+ *
+ *  Not thread safe; call from the message thread.
+ */
+class FrequencyResponseCurve
+{
+public:
+    using Coefficients = juce::dsp::IIR::Coefficients<float>;
+
+    FrequencyResponseCurve() = default;
+
+    /**
+     * Sets up the column grid, if any of its inputs changed.
+     *
+     * @param numColumns    Width of the plot in pixels.
+     * @param sampleRate    Sample rate the filters run at.
+     * @param minFrequency  Frequency at the left edge of the plot.
+     * @param numOctaves    Octaves spanned by the plot.
+     */
+    void setGrid(int numColumns, double sampleRate, float minFrequency, float numOctaves);
+
+    /**
+     * Builds a path through gain times the product of the filters' magnitude responses.
+     *
+     * @param filters       Sections to multiply; null entries are treated as unity.
+     * @param bounds        Plot area; +maxDecibels is at the top and -maxDecibels at the bottom.
+     */
+    void createPath(juce::Path& path, const std::vector<Coefficients::Ptr>& filters, double gain,
+                    juce::Rectangle<float> bounds, float maxDecibels);
+
+    /**
+     * Writes |H|^2 of a first or second order section at each of numPoints values of
+     * phi = sin^2(pi f / sampleRate).
+     */
+    static void getMagnitudesSquared(const Coefficients& filter, const double* phi, double* dest, int numPoints) noexcept;
+
+private:
+    /** Adds points around the resonances of a section that the column grid would miss. */
+    void addResonancePoints(const Coefficients& filter);
+    /** Adds a point at normalised angular frequency w, if it lies on the plot. */
+    void addPoint(double w);
+
+    struct Point
+    {
+        double x = 0.0;
+        double phi = 0.0;
+    };
+
+    std::vector<Point> _columns;
+    std::vector<Point> _extraPoints;
+    std::vector<Point> _points;
+    std::vector<double> _phi;
+    std::vector<double> _product;
+    std::vector<double> _scratch;
+
+    int _numColumns = 0;
+    double _sampleRate = 0.0;
+    float _minFrequency = 0.0f;
+    float _numOctaves = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrequencyResponseCurve)
+};
@@ -7,7 +7,8 @@ ParametricEqualiserEditor::ParametricEqualiserEditor(ParametricEqualiserProcesso
                                                      juce::AudioProcessorValueTreeState& vts)
     : juce::AudioProcessorEditor(&audioProcessor),
     _audioProcessor(audioProcessor),
-    _audioProcessorState(vts)
+    _audioProcessorState(vts),
+    _analyserSubscription(audioProcessor)
 {
     _tooltipWindow->setMillisecondsBeforeTipAppears(1000);
     // Create edtor controls for each equalizer band
@@ -30,6 +31,40 @@ ParametricEqualiserEditor::ParametricEqualiserEditor(ParametricEqualiserProcesso
                                                            ParametricEqualiserProcessor::paramOutput, 
                                                            _outputGainSlider));
 
+    // Create the measured response toggle.
+    _measureButton.setClickingTogglesState(true);
+    _measureButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::white.withAlpha(0.3f));
+    _measureButton.setTooltip(TRANS("Show the response measured from the audio, and how coherent the measurement is"));
+    _measureButton.onClick = [this]
+    {
+        if (_measureButton.getToggleState())
+        {
+            _measurementSubscription = std::make_unique<ParametricEqualiserProcessor::MeasurementSubscription>(_audioProcessor);
+            _measurementSubscription->setVisible(isShowing());
+        }
+        else
+        {
+            _measurementSubscription.reset();
+        }
+        submitPlotLayers(_plotFrame);
+    };
+    addAndMakeVisible(_measureButton);
+
+    // Create the spectrogram toggle.
+    _spectrogramButton.setClickingTogglesState(true);
+    _spectrogramButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::white.withAlpha(0.3f));
+    _spectrogramButton.setTooltip(TRANS("Show how the output spectrum changes over time behind the plot"));
+    _spectrogramButton.onClick = [this]
+    {
+        _spectrogram.clear();
+        repaint(_plotFrame);
+    };
+    addAndMakeVisible(_spectrogramButton);
+    addAndMakeVisible(_stereoScopeView);
+#if EVILAUDIO_PAINT_PROFILING
+    addAndMakeVisible(_paintProfilerOverlay);
+#endif
+
     // Initialize the size of the equalizer editor.
     auto size = _audioProcessor.getSavedSize(); 
     setResizable(false, false);
@@ -44,29 +79,188 @@ ParametricEqualiserEditor::ParametricEqualiserEditor(ParametricEqualiserProcesso
     openGLContext.attachTo(*getTopLevelComponent());
 #endif
 
-    _audioProcessor.addChangeListener(this);
+    // Repaint whatever changed as soon as the render thread has drawn it.
+    _plotRenderer.onFrameReady = [this](juce::Rectangle<int> dirty)
+    {
+        repaint(dirty.getIntersection(getLocalBounds()));
+    };
 
-    // Refresh the display at 30 Hz.
-    startTimerHz(30);
+    // The display is refreshed from the vblank while the editor is showing.
+    updateVBlankAttachment();
 }
 
 ParametricEqualiserEditor::~ParametricEqualiserEditor()
 {
     juce::PopupMenu::dismissAllActiveMenus();
-    _audioProcessor.removeChangeListener(this);
 #ifdef JUCE_OPENGL
     openGLContext.detach();
 #endif
 }
 
 void ParametricEqualiserEditor::paint(juce::Graphics& g) {
+    EVILAUDIO_PROFILE_PAINT(*this);
     juce::Graphics::ScopedSaveState state(g);
+    const auto paintStart = juce::Time::getMillisecondCounterHiRes();
+
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+
+    if (_spectrogramButton.getToggleState())
+        _spectrogram.draw(g, _plotFrame.getTopLeft());
+
+    // The grid and its labels only change with the size or look and feel, so they are
+    // drawn into an image at the display's pixel scale once and blitted from then on.
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != _paintScale)
+    {
+        _paintScale = scale;
+        submitPlotLayers(_plotFrame);
+    }
+    const auto backgroundArea = _plotFrame.expanded(2);
+    if (! _backgroundImage.isValid() || _backgroundScale != scale)
+    {
+        _backgroundScale = scale;
+        _backgroundImage = juce::Image(juce::Image::ARGB,
+                                       juce::jmax(1, juce::roundToInt(backgroundArea.getWidth() * scale)),
+                                       juce::jmax(1, juce::roundToInt(backgroundArea.getHeight() * scale)), true);
+        juce::Graphics background(_backgroundImage);
+        background.addTransform(juce::AffineTransform::translation(-backgroundArea.getPosition().toFloat()).scaled(scale));
+        paintBackground(background);
+    }
+    g.drawImage(_backgroundImage, backgroundArea.toFloat());
+
+    // The analyser spectra and response curves were rasterised by the plot renderer.
+    _plotRenderer.draw(g);
+    paintOverlay(g);
+
+    const auto paintSeconds = (juce::Time::getMillisecondCounterHiRes() - paintStart) * 0.001;
+    _paintSeconds += 0.1 * (paintSeconds - _paintSeconds);
+}
 
+void ParametricEqualiserEditor::submitPlotLayers(juce::Rectangle<int> dirty) {
+    std::vector<PlotRenderer::Stroke> strokes;
+    strokes.reserve(size_t(_bandEditors.size()) + 7);
+    addAnalyserStrokes(strokes);
+    addResponseStrokes(strokes);
+
+    _plotRenderer.submit(std::move(strokes), _plotFrame, _paintScale, dirty);
+}
+
+void ParametricEqualiserEditor::addAnalyserStrokes(std::vector<PlotRenderer::Stroke>& strokes) {
     const auto inputColour = juce::Colours::greenyellow;
     const auto outputColour = juce::Colours::indianred;
 
-    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+    // The analyser spectra, with the second stream of the L/R and M/S modes fainter.
+    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, true);
+    strokes.push_back({ _analyserPath, inputColour, 1.0f });
+    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, true, true);
+    strokes.push_back({ _analyserPath, inputColour.withMultipliedAlpha(0.5f), 1.0f });
+    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, false);
+    strokes.push_back({ _analyserPath, outputColour, 1.0f });
+    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, false, true);
+    strokes.push_back({ _analyserPath, outputColour.withMultipliedAlpha(0.5f), 1.0f });
+}
+
+void ParametricEqualiserEditor::addResponseStrokes(std::vector<PlotRenderer::Stroke>& strokes) {
+    // The measured response next to the theoretical one, with its coherence underneath.
+    if (_measurementSubscription != nullptr)
+    {
+        _audioProcessor.createMeasuredResponsePlot(_measuredResponsePath, _coherencePath, _plotFrame, 20.0f, maxDB);
+        strokes.push_back({ _coherencePath, juce::Colours::skyblue.withAlpha(0.4f), 1.0f });
+        strokes.push_back({ _measuredResponsePath, juce::Colours::white, 1.5f });
+    }
+
+    // The frequency response of each band, and of all of them together.
+    for (size_t i = 0; i < _audioProcessor.getNumBands(); ++i) {
+        auto* band = _audioProcessor.getBand(i);
+        strokes.push_back({ _bandEditors.getUnchecked(int(i))->frequencyResponse,
+                            band->active ? band->colour : band->colour.withAlpha(0.3f), 1.0f });
+    }
+    strokes.push_back({ _frequencyResponsePath, juce::Colours::silver, 1.0f });
+}
+
+void ParametricEqualiserEditor::paintLayer(juce::Graphics& g, Layer layer) {
+    std::vector<PlotRenderer::Stroke> strokes;
+
+    switch (layer)
+    {
+        case Layer::background:  paintBackground(g); return;
+        case Layer::spectrogram: _spectrogram.draw(g, _plotFrame.getTopLeft()); return;
+        case Layer::overlay:     paintOverlay(g); return;
+        case Layer::analyser:    addAnalyserStrokes(strokes); break;
+        case Layer::responses:   addResponseStrokes(strokes); break;
+    }
+
+    // The same strokes the plot renderer would draw, but on this thread.
+    juce::Graphics::ScopedSaveState state(g);
+    g.reduceClipRegion(_plotFrame);
+    for (const auto& stroke : strokes)
+    {
+        g.setColour(stroke.colour);
+        g.strokePath(stroke.path, juce::PathStrokeType(stroke.thickness));
+    }
+}
+
+void ParametricEqualiserEditor::setSpectrogramVisible(bool shouldBeVisible) {
+    if (shouldBeVisible != _spectrogramButton.getToggleState())
+    {
+        _spectrogramButton.setToggleState(shouldBeVisible, juce::dontSendNotification);
+        _spectrogram.clear();
+        repaint(_plotFrame);
+    }
+}
+
+bool ParametricEqualiserEditor::waitForPlotRenderer(int timeoutMilliseconds) {
+    return _plotRenderer.waitForLatestScene(timeoutMilliseconds);
+}
+
+void ParametricEqualiserEditor::paintOverlay(juce::Graphics& g) {
+    juce::Graphics::ScopedSaveState state(g);
+    const auto inputColour = juce::Colours::greenyellow;
+    const auto outputColour = juce::Colours::indianred;
+
+    g.setFont(12.0f);
+    g.setColour(juce::Colours::silver);
+    g.reduceClipRegion(_plotFrame);
+
+    //g.setFont(16.0f);
+
+    // In the L/R and M/S modes each analyser draws two spectra; the second one is fainter.
+    juce::String streamNames;
+    switch (_audioProcessor.getAnalyserSettings().channelMode)
+    {
+        case AnalyserSettings::ChannelMode::left:      streamNames = " (L)"; break;
+        case AnalyserSettings::ChannelMode::right:     streamNames = " (R)"; break;
+        case AnalyserSettings::ChannelMode::leftRight: streamNames = " L / R"; break;
+        case AnalyserSettings::ChannelMode::midSide:   streamNames = " M / S"; break;
+        default: break;
+    }
+
+    g.setColour(inputColour);
+    g.drawFittedText("Input" + streamNames, _plotFrame.reduced(8), juce::Justification::topRight, 1);
+    g.setColour(outputColour);
+    g.drawFittedText("Output" + streamNames, _plotFrame.reduced(8, 28), juce::Justification::topRight, 1);
+    if (_measurementSubscription != nullptr)
+    {
+        g.setColour(juce::Colours::skyblue.withAlpha(0.4f));
+        g.drawFittedText("Coherence", _plotFrame.reduced(8, 48), juce::Justification::topRight, 1);
+        g.setColour(juce::Colours::white);
+        g.drawFittedText("Measured", _plotFrame.reduced(8, 68), juce::Justification::topRight, 1);
+    }
+
+    // Draw the handle of each band.
+    for (size_t i = 0; i < _audioProcessor.getNumBands(); ++i) {
+        auto* band = _audioProcessor.getBand(i);
+
+        g.setColour(_draggingBand == int(i) ? band->colour : band->colour.withAlpha(0.3f));
+        auto x = juce::roundToInt(_plotFrame.getX() + _plotFrame.getWidth() * getPositionForFrequency(float(band->frequency)));
+        auto y = juce::roundToInt(getPositionForGain(float(band->gain), float(_plotFrame.getY()), float(_plotFrame.getBottom())));
+        g.drawVerticalLine(x, float(_plotFrame.getY()), float(y - 5));
+        g.drawVerticalLine(x, float(y + 5), float(_plotFrame.getBottom()));
+        g.fillEllipse(float(x - 3), float(y - 3), 6.0f, 6.0f);
+    }
+}
 
+void ParametricEqualiserEditor::paintBackground(juce::Graphics& g) {
     g.setFont(12.0f);
     g.setColour(juce::Colours::silver);
     g.drawRoundedRectangle(_plotFrame.toFloat(), 5, 2);
@@ -92,44 +286,15 @@ void ParametricEqualiserEditor::paint(juce::Graphics& g) {
     g.drawFittedText(juce::String(maxDB / 2) + " dB", _plotFrame.getX() + 3, juce::roundToInt(_plotFrame.getY() + 2 + 0.25 * _plotFrame.getHeight()), 50, 14, juce::Justification::left, 1);
     g.drawFittedText(" 0 dB", _plotFrame.getX() + 3, juce::roundToInt(_plotFrame.getY() + 2 + 0.5 * _plotFrame.getHeight()), 50, 14, juce::Justification::left, 1);
     g.drawFittedText(juce::String(-maxDB / 2) + " dB", _plotFrame.getX() + 3, juce::roundToInt(_plotFrame.getY() + 2 + 0.75 * _plotFrame.getHeight()), 50, 14, juce::Justification::left, 1);
+}
 
-    g.reduceClipRegion(_plotFrame);
-
-    //g.setFont(16.0f);
-
-    // Draw the input analyser plot.
-    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, true);
-    g.setColour(inputColour);
-    g.drawFittedText("Input", _plotFrame.reduced(8), juce::Justification::topRight, 1);
-    g.strokePath(_analyserPath, juce::PathStrokeType(1.0));
-
-    // Draw the output analyser plot.
-    _audioProcessor.createAnalyserPlot(_analyserPath, _plotFrame, 20.0f, false);
-    g.setColour(outputColour);
-    g.drawFittedText("Output", _plotFrame.reduced(8, 28), juce::Justification::topRight, 1);
-    g.strokePath(_analyserPath, juce::PathStrokeType(1.0));
-            
-    // Draw the frequency response for each band.
-    for (size_t i = 0; i < _audioProcessor.getNumBands(); ++i) {
-        auto* bandEditor = _bandEditors.getUnchecked(int(i));
-        auto* band = _audioProcessor.getBand(i);
-
-        g.setColour(band->active ? band->colour : band->colour.withAlpha(0.3f));
-        g.strokePath(bandEditor->frequencyResponse, juce::PathStrokeType(1.0));
-        
-        g.setColour(_draggingBand == int(i) ? band->colour : band->colour.withAlpha(0.3f));
-        auto x = juce::roundToInt(_plotFrame.getX() + _plotFrame.getWidth() * getPositionForFrequency(float(band->frequency)));
-        auto y = juce::roundToInt(getPositionForGain(float(band->gain), float(_plotFrame.getY()), float(_plotFrame.getBottom())));
-        g.drawVerticalLine(x, float(_plotFrame.getY()), float(y - 5));
-        g.drawVerticalLine(x, float(y + 5), float(_plotFrame.getBottom()));
-        g.fillEllipse(float(x - 3), float(y - 3), 6.0f, 6.0f);
-    }
-    
-    g.setColour(juce::Colours::silver);
-    g.strokePath(_frequencyResponsePath, juce::PathStrokeType(1.0f));
+void ParametricEqualiserEditor::lookAndFeelChanged() {
+    _backgroundImage = {};
+    repaint();
 }
 
 void ParametricEqualiserEditor::resized() {
+    EVILAUDIO_PROFILE_LAYOUT(*this);
     _audioProcessor.setSavedSize({ getWidth(), getHeight() });
     _plotFrame = getLocalBounds().reduced(3, 3);
 
@@ -146,30 +311,77 @@ void ParametricEqualiserEditor::resized() {
 
     _plotFrame.reduce(3, 3);
     _brandingFrame = bandSpace.reduced(5);
+    _measureButton.setBounds(_brandingFrame.removeFromTop(24));
+    _spectrogramButton.setBounds(_brandingFrame.removeFromTop(28).withTrimmedTop(4));
+    _stereoScopeView.setBounds(_brandingFrame.withTrimmedTop(6));
+#if EVILAUDIO_PAINT_PROFILING
+    _paintProfilerOverlay.setTopLeftPosition(8, 8);
+#endif
+    _spectrogram.setSize(_plotFrame.getWidth(), _plotFrame.getHeight());
+    _backgroundImage = {};
 
     updateFrequencyResponses();
+    submitPlotLayers(getLocalBounds());
 }
 
 void ParametricEqualiserEditor::updateFrequencyResponses() {
-    auto pixelsPerDouble = 2.0f * _plotFrame.getHeight() / juce::Decibels::decibelsToGain(maxDB);
+    for (auto& state : _bandStates)
+        state.valid = false;
+
+    _lastResponseGeneration = _audioProcessor.getResponseGeneration();
+    _audioProcessor.updateResponses();
+    updateChangedResponses();
+};
+
+juce::Rectangle<int> ParametricEqualiserEditor::updateChangedResponses() {
+    const auto curveArea = [](const juce::Path& p) { return p.getBounds().getSmallestIntegerContainer().expanded(2); };
+
+    juce::Rectangle<int> dirty;
+    _bandStates.resize(size_t(_bandEditors.size()));
 
     for (int i = 0; i < _bandEditors.size(); ++i)
     {
         auto* bandEditor = _bandEditors.getUnchecked(i);
+        auto& state = _bandStates[size_t(i)];
+
+        const auto solo = _audioProcessor.getBandSolo(i);
+        if (! state.valid || state.solo != solo)
+            bandEditor->updateSoloState(solo);
+        state.solo = solo;
 
         if (auto* band = _audioProcessor.getBand(size_t(i)))
         {
-            bandEditor->updateControls(band->type);
-            bandEditor->frequencyResponse.clear();
-            _audioProcessor.createFrequencyPlot(bandEditor->frequencyResponse, 
-                                                band->magnitudes, _plotFrame.withX(_plotFrame.getX() + 1), pixelsPerDouble);
+            if (! state.valid || state.type != band->type)
+                bandEditor->updateControls(band->type);
+
+            // Only a band whose response changed gets a new curve; both the old and the
+            // new curve and handle have to be repainted.
+            const auto handle = getBandHandleBounds(*band);
+            if (! state.valid || state.responseVersion != band->responseVersion)
+            {
+                dirty = dirty.getUnion(curveArea(bandEditor->frequencyResponse)).getUnion(state.handle);
+                _audioProcessor.createFrequencyPlot(bandEditor->frequencyResponse, i, _plotFrame, maxDB);
+                dirty = dirty.getUnion(curveArea(bandEditor->frequencyResponse)).getUnion(handle);
+            }
+
+            state.type = band->type;
+            state.responseVersion = band->responseVersion;
+            state.handle = handle;
         }
-        bandEditor->updateSoloState(_audioProcessor.getBandSolo(i));
+        state.valid = true;
     }
-    _frequencyResponsePath.clear();
-    _audioProcessor.createFrequencyPlot(_frequencyResponsePath, 
-                                        _audioProcessor.getMagnitudes(), _plotFrame, pixelsPerDouble);
-};
+
+    // The sum depends on every band, the solo state and the output gain, so it is always rebuilt.
+    dirty = dirty.getUnion(curveArea(_frequencyResponsePath));
+    _audioProcessor.createFrequencyPlot(_frequencyResponsePath, -1, _plotFrame, maxDB);
+    return dirty.getUnion(curveArea(_frequencyResponsePath));
+}
+
+juce::Rectangle<int> ParametricEqualiserEditor::getBandHandleBounds(const ParametricEqualiserProcessor::Band& band) const
+{
+    const auto x = juce::roundToInt(_plotFrame.getX() + _plotFrame.getWidth() * getPositionForFrequency(float(band.frequency)));
+    return { x - 4, _plotFrame.getY(), 9, _plotFrame.getHeight() };
+}
 
 float ParametricEqualiserEditor::getPositionForFrequency(float freq)
 {
@@ -191,17 +403,89 @@ float ParametricEqualiserEditor::getGainForPosition(float pos, float top, float
     return juce::Decibels::decibelsToGain(juce::jmap(pos, bottom, top, -maxDB, maxDB), -maxDB);
 }
 
-void ParametricEqualiserEditor::changeListenerCallback(juce::ChangeBroadcaster* sender)
+void ParametricEqualiserEditor::onVBlank(double timestampSec)
 {
-    juce::ignoreUnused(sender);
-    updateFrequencyResponses();
-    repaint();
+    if (_lastVBlankTime > 0.0)
+    {
+        // Ignore gaps (e.g. while the window was being dragged) when tracking the interval.
+        const auto interval = timestampSec - _lastVBlankTime;
+        if (interval > 0.0 && interval < 0.1)
+            _vBlankInterval += 0.1 * (interval - _vBlankInterval);
+    }
+    _lastVBlankTime = timestampSec;
+
+    // A minimised window still gets vblanks on some platforms.
+    if (timestampSec < _nextUpdateTime || ! isShowing())
+        return;
+
+    // Painting may take up to half of each frame. If it takes longer, refresh only every
+    // few vblanks so the message thread keeps up with the host and the mouse.
+    const auto framesPerUpdate = juce::jlimit(1, 8, int(std::ceil(_paintSeconds / (0.5 * _vBlankInterval))));
+    _nextUpdateTime = timestampSec + (framesPerUpdate - 0.5) * _vBlankInterval;
+
+    updateDisplay();
 }
 
-void ParametricEqualiserEditor::timerCallback()
+void ParametricEqualiserEditor::updateVBlankAttachment()
 {
-    if (_audioProcessor.checkForNewAnalyserData())
-        repaint(_plotFrame);
+    if (! isShowing())
+        _vBlankAttachment.reset();
+    else if (_vBlankAttachment == nullptr)
+        _vBlankAttachment = std::make_unique<juce::VBlankAttachment>(this, [this](double timestampSec) { onVBlank(timestampSec); });
+}
+
+void ParametricEqualiserEditor::updateDisplay()
+{
+    juce::Rectangle<int> dirty;
+
+    // However many parameters changed since the last frame, the curves are updated once.
+    const auto responseGeneration = _audioProcessor.getResponseGeneration();
+    if (responseGeneration != _lastResponseGeneration)
+    {
+        _lastResponseGeneration = responseGeneration;
+        _audioProcessor.updateResponses();
+        dirty = updateChangedResponses();
+    }
+
+    // One spectrogram row per new output frame; frames published between two ticks
+    // are represented by the newest of them.
+    const auto outputGeneration = _audioProcessor.getAnalyserGeneration(false);
+    if (_spectrogramButton.getToggleState() && outputGeneration != _lastSpectrogramGeneration)
+    {
+        _lastSpectrogramGeneration = outputGeneration;
+        if (const auto* frame = _audioProcessor.getLatestAnalyserFrame(false))
+            _spectrogram.addFrame(*frame, 20.0f);
+    }
+
+    // The phase views are a separate component and repaint themselves.
+    _stereoScopeView.update();
+
+    const auto generation = _audioProcessor.getAnalyserGeneration();
+    if (generation != _lastAnalyserGeneration)
+    {
+        _lastAnalyserGeneration = generation;
+        dirty = _plotFrame;
+    }
+
+    // The repaint happens once the renderer has the new layers ready.
+    if (! dirty.isEmpty())
+        submitPlotLayers(dirty);
+}
+
+void ParametricEqualiserEditor::visibilityChanged()
+{
+    updateVBlankAttachment();
+    _analyserSubscription.setVisible(isShowing());
+    if (_measurementSubscription != nullptr)
+        _measurementSubscription->setVisible(isShowing());
+}
+
+void ParametricEqualiserEditor::parentHierarchyChanged()
+{
+    updateVBlankAttachment();
+    _analyserSubscription.setVisible(isShowing());
+    if (_measurementSubscription != nullptr)
+        _measurementSubscription->setVisible(isShowing());
 }
 
 void ParametricEqualiserEditor::mouseDown(const juce::MouseEvent& e) {
@@ -233,8 +517,81 @@ void ParametricEqualiserEditor::mouseDown(const juce::MouseEvent& e) {
         }
     }
 
+    showAnalyserMenu(e);
 };
 
+void ParametricEqualiserEditor::showAnalyserMenu(const juce::MouseEvent& e) {
+    using Window = juce::dsp::WindowingFunction<float>;
+    using Averaging = AnalyserSettings::Averaging;
+    using ChannelMode = AnalyserSettings::ChannelMode;
+
+    const auto settings = _audioProcessor.getAnalyserSettings();
+
+    juce::PopupMenu fftSizes;
+    for (int order = AnalyserSettings::minFftOrder; order <= AnalyserSettings::maxFftOrder; ++order)
+        fftSizes.addItem(TRANS("FFT") + " " + juce::String(1 << order), true, settings.fftOrder == order,
+            [this, order] { auto s = _audioProcessor.getAnalyserSettings(); s.fftOrder = order; _audioProcessor.setAnalyserSettings(s); });
+
+    juce::PopupMenu overlaps;
+    for (auto overlap : { 0.0f, 0.5f, 0.75f, 0.875f })
+        overlaps.addItem(juce::String(overlap * 100.0f, overlap == 0.875f ? 1 : 0) + " %", true, settings.overlap == overlap,
+            [this, overlap] { auto s = _audioProcessor.getAnalyserSettings(); s.overlap = overlap; _audioProcessor.setAnalyserSettings(s); });
+
+    juce::PopupMenu windows;
+    const std::pair<Window::WindowingMethod, juce::String> windowNames[] = {
+        { Window::hann, TRANS("Hann") },
+        { Window::hamming, TRANS("Hamming") },
+        { Window::blackman, TRANS("Blackman") },
+        { Window::blackmanHarris, TRANS("Blackman-Harris") },
+        { Window::flatTop, TRANS("Flat Top") },
+        { Window::rectangular, TRANS("Rectangular") }
+    };
+    for (const auto& [method, name] : windowNames)
+        windows.addItem(name, true, settings.window == method,
+            [this, method = method] { auto s = _audioProcessor.getAnalyserSettings(); s.window = method; _audioProcessor.setAnalyserSettings(s); });
+
+    juce::PopupMenu averaging;
+    const std::pair<Averaging, juce::String> averagingNames[] = {
+        { Averaging::boxcar, TRANS("Boxcar") },
+        { Averaging::exponential, TRANS("Exponential") },
+        { Averaging::peakHold, TRANS("Peak Hold") }
+    };
+    for (const auto& [mode, name] : averagingNames)
+        averaging.addItem(name, true, settings.averaging == mode,
+            [this, mode = mode] { auto s = _audioProcessor.getAnalyserSettings(); s.averaging = mode; _audioProcessor.setAnalyserSettings(s); });
+
+    juce::PopupMenu smoothing;
+    for (auto fraction : { 0, 1, 3, 6, 12, 24 })
+        smoothing.addItem(fraction == 0 ? TRANS("Off") : "1/" + juce::String(fraction) + " " + TRANS("octave"),
+            true, settings.octaveFraction == fraction,
+            [this, fraction] { auto s = _audioProcessor.getAnalyserSettings(); s.octaveFraction = fraction; _audioProcessor.setAnalyserSettings(s); });
+
+    juce::PopupMenu channels;
+    const std::pair<ChannelMode, juce::String> channelNames[] = {
+        { ChannelMode::mono, TRANS("Mono Sum") },
+        { ChannelMode::left, TRANS("Left") },
+        { ChannelMode::right, TRANS("Right") },
+        { ChannelMode::leftRight, TRANS("Left + Right") },
+        { ChannelMode::midSide, TRANS("Mid + Side") }
+    };
+    for (const auto& [mode, name] : channelNames)
+        channels.addItem(name, true, settings.channelMode == mode,
+            [this, mode = mode] { auto s = _audioProcessor.getAnalyserSettings(); s.channelMode = mode; _audioProcessor.setAnalyserSettings(s); });
+
+    _contextMenu.clear();
+    _contextMenu.addSectionHeader(TRANS("Analyser"));
+    _contextMenu.addSubMenu(TRANS("Resolution"), fftSizes);
+    _contextMenu.addSubMenu(TRANS("Overlap"), overlaps);
+    _contextMenu.addSubMenu(TRANS("Window"), windows);
+    _contextMenu.addSubMenu(TRANS("Averaging"), averaging);
+    _contextMenu.addSubMenu(TRANS("Smoothing"), smoothing);
+    _contextMenu.addSubMenu(TRANS("Channels"), channels);
+
+    _contextMenu.showMenuAsync(juce::PopupMenu::Options()
+        .withTargetComponent(this)
+        .withTargetScreenArea({ e.getScreenX(), e.getScreenY(), 1, 1 }));
+}
+
 void ParametricEqualiserEditor::mouseMove(const juce::MouseEvent& e) {
     if (_plotFrame.contains(e.x, e.y))
     {
@@ -345,6 +702,7 @@ ParametricEqualiserEditor::BandEditor::BandEditor(size_t index,
 };
 
 void ParametricEqualiserEditor::BandEditor::resized() {
+    EVILAUDIO_PROFILE_LAYOUT(*this);
     auto localBounds = getLocalBounds();
     _frame.setBounds(localBounds);
 
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <evilaudio_lookandfeel/evilaudio_lookandfeel.h>
 #include "ParametricEqualiserProcessor.h"
+#include "PlotRenderer.h"
+#include "Spectrogram.h"
+#include "StereoScopeView.h"
 
 /*
 Pseudocode plan (detailed step-by-step):
@@ -36,9 +40,7 @@ Pseudocode plan (detailed step-by-step):
  *   - Registers change listeners and timers as needed in implementation.
  */
 class ParametricEqualiserEditor :
-    public juce::AudioProcessorEditor,
-    public juce::ChangeListener,
-    public juce::Timer
+    public juce::AudioProcessorEditor
 {
 public:
     /// Attachment type used for sliders (alias).
@@ -79,25 +81,67 @@ public:
      */
     void resized() override;
     /**
-     * Callback for change messages from ChangeBroadcaster(s) this editor listens to.
+     * Called when the look and feel changes; the cached background is redrawn with it.
+     */
+    void lookAndFeelChanged() override;
+    /**
+     * Picks up new analyser frames and parameter changes and repaints what they affect.
+     *
+     * Called from the display's vertical blank, at most once per refresh interval. Parameter
+     * changes are picked up here by polling the processor's response generation, so any
+     * number of them between two frames cost a single update.
+     */
+    void updateDisplay();
+    /**
+     * Called when this editor or one of its parents is shown or hidden.
      *
-     * @param sender The broadcaster that sent the change message (may be nullptr in some cases).
+     * Lets the processor schedule analysis for visible editors ahead of hidden ones, and
+     * detaches from the display's vertical blank while the editor isn't showing.
      */
-    void changeListenerCallback(juce::ChangeBroadcaster* sender) override;
+    void visibilityChanged() override;
     /**
-     * Timer callback invoked periodically when this object is started as a Timer.
+     * Called when the editor is added to or removed from a parent or window.
      *
-     * Typical use: update analyser data, refresh display paths, or throttle UI updates.
+     * Updates the analyser visibility in the same way as visibilityChanged().
      */
-    void timerCallback() override;
+    void parentHierarchyChanged() override;
     /**
      * Recompute the frequency response Paths used for global and per-band rendering.
      *
      * This function should sample the filter responses and construct juce::Path objects
-     * stored in the editor for painting.
+     * stored in the editor for painting. Rebuilds every band; change messages from the
+     * processor's response generation go through updateChangedResponses() instead.
      */
     void updateFrequencyResponses();
 
+    /** The parts of the plot, in the order paint() draws them. */
+    enum class Layer
+    {
+        background,     ///< Frame, grid and axis labels (normally cached in an image).
+        spectrogram,    ///< Output spectrogram behind the plot.
+        analyser,       ///< Input and output spectra (normally drawn by the plot renderer).
+        responses,      ///< Band, sum and measured responses (normally drawn by the plot renderer).
+        overlay         ///< Analyser labels and band handles.
+    };
+    /**
+     * Draw one layer of the plot straight into g, on the calling thread.
+     *
+     * Bypasses the background cache and the plot renderer, so the cost is that of building
+     * and drawing the layer from scratch. Used by the editor benchmark to time each layer.
+     */
+    void paintLayer(juce::Graphics& g, Layer layer);
+    /**
+     * Show or hide the spectrogram behind the plot, as its toggle button does.
+     */
+    void setSpectrogramVisible(bool shouldBeVisible);
+    /**
+     * Block until the plot renderer has drawn the layers last submitted by updateDisplay(),
+     * so that the next paint() shows them. Used by the editor benchmark.
+     *
+     * @return false if the renderer didn't finish within the timeout.
+     */
+    bool waitForPlotRenderer(int timeoutMilliseconds);
+
     /**
      * Mouse event handlers to support direct-manipulation of bands on the response plot.
      *
@@ -118,6 +162,55 @@ private:
      * @return Normalized position [0, 1] corresponding to left..right of the plot.
      */
     static float getPositionForFrequency(float freq);
+    /**
+     * Vertical blank callback. Calls updateDisplay() every vblank, or every few under load.
+     *
+     * @param timestampSec Time of the vblank in seconds.
+     */
+    void onVBlank(double timestampSec);
+    /**
+     * Attach to the display's vertical blank while the editor is showing, detach otherwise.
+     */
+    void updateVBlankAttachment();
+    /**
+     * Rebuild the curves of the bands whose response changed since the last call, and the sum.
+     *
+     * Also refreshes the controls of bands whose type or solo state changed.
+     *
+     * @return The area covered by the old and new versions of every rebuilt curve and handle.
+     */
+    juce::Rectangle<int> updateChangedResponses();
+    /**
+     * The area covered by a band's handle and its vertical marker line in the plot.
+     */
+    juce::Rectangle<int> getBandHandleBounds(const ParametricEqualiserProcessor::Band& band) const;
+    /**
+     * Draw the static part of the plot: its frame, grid lines and axis labels.
+     *
+     * Only called to refresh the cached background image, not on every repaint.
+     */
+    void paintBackground(juce::Graphics& g);
+    /**
+     * Build the analyser and response paths and hand them to the plot renderer.
+     *
+     * @param dirty The area to repaint once the renderer has drawn them.
+     */
+    void submitPlotLayers(juce::Rectangle<int> dirty);
+    /** Append the strokes of the analyser spectra, in drawing order. */
+    void addAnalyserStrokes(std::vector<PlotRenderer::Stroke>& strokes);
+    /** Append the strokes of the measured, per-band and summed responses, in drawing order. */
+    void addResponseStrokes(std::vector<PlotRenderer::Stroke>& strokes);
+    /**
+     * Draw the parts of the plot that go over the rendered layers: the analyser labels and
+     * the band handles.
+     */
+    void paintOverlay(juce::Graphics& g);
+    /**
+     * Show the analyser settings menu (FFT size, overlap, window, averaging, smoothing and channels).
+     *
+     * Opened by right-clicking the plot away from any band.
+     */
+    void showAnalyserMenu(const juce::MouseEvent& e);
     /**
      * Convert a normalized horizontal position in the plot back to frequency in Hz.
      *
@@ -271,6 +364,11 @@ private:
     /** Reference to the AudioProcessorValueTreeState used for all parameter attachments. */
     juce::AudioProcessorValueTreeState& _audioProcessorState;
 
+    /** Keeps the processor's analysers running while this editor exists. */
+    ParametricEqualiserProcessor::AnalyserSubscription _analyserSubscription;
+    /** Keeps the transfer-function measurement running while the measure button is on. */
+    std::unique_ptr<ParametricEqualiserProcessor::MeasurementSubscription> _measurementSubscription;
+
     /** OwnedArray that stores attachments for any top-level sliders. */
     juce::OwnedArray<SliderAttachment> _sliderAttachments;
 
@@ -290,6 +388,10 @@ private:
     };
     /** Attachment that binds the output gain slider to the VTS. */
     std::unique_ptr<SliderAttachment> _outputGainSliderAttachment;
+    /** Toggles the measured response and coherence plots. */
+    juce::TextButton _measureButton{ TRANS("Measure response") };
+    /** Toggles the spectrogram of the output behind the plot. */
+    juce::TextButton _spectrogramButton{ TRANS("Spectrogram") };
 
 
     /** Rectangle describing the plotting area for frequency response rendering. */
@@ -300,10 +402,54 @@ private:
     juce::SharedResourcePointer<juce::TooltipWindow> _tooltipWindow;
     /** Popup menu used for context-sensitive options (right-click menu). */
     juce::PopupMenu _contextMenu;
+    /** The frame, grid and labels of the plot, rendered at _backgroundScale; invalid when stale. */
+    juce::Image _backgroundImage;
+    float _backgroundScale = 0.0f;
+    /** What each band's curve and controls were last built from. */
+    struct BandState
+    {
+        juce::uint32 responseVersion = 0;
+        ParametricEqualiserProcessor::FilterType type = ParametricEqualiserProcessor::NoFilter;
+        bool solo = false;
+        juce::Rectangle<int> handle;
+        /** False until built, or after everything has to be rebuilt (e.g. on resize). */
+        bool valid = false;
+    };
+    std::vector<BandState> _bandStates;
     /** Cached full-band frequency response path used for painting. */
     juce::Path _frequencyResponsePath;
     /** Cached analyser path used when visualising audio in real-time. */
     juce::Path _analyserPath;
+    /** Measured transfer function and its coherence, drawn while measuring. */
+    juce::Path _measuredResponsePath;
+    juce::Path _coherencePath;
+    /** Physical pixel scale of the last paint, used for the offscreen layers. */
+    float _paintScale = 1.0f;
+    /** Rasterises the analyser and response layers on its own thread. */
+    PlotRenderer _plotRenderer;
+    /** Drives updateDisplay() from the display refresh; only exists while showing. */
+    std::unique_ptr<juce::VBlankAttachment> _vBlankAttachment;
+    /** Time of the previous vblank and the smoothed interval between vblanks, in seconds. */
+    double _lastVBlankTime = 0.0;
+    double _vBlankInterval = 1.0 / 60.0;
+    /** The next vblank time at which updateDisplay() may run again. */
+    double _nextUpdateTime = 0.0;
+    /** Smoothed time spent in paint(), in seconds. */
+    double _paintSeconds = 0.0;
+    /** Processor response generation the curves were last built from. */
+    juce::uint64 _lastResponseGeneration = 0;
+    /** Analyser frame generation that was current at the last repaint. */
+    juce::uint64 _lastAnalyserGeneration = 0;
+    /** History of the output spectrum, one row per analyser frame. */
+    Spectrogram _spectrogram;
+    /** Output analyser generation of the newest row in the spectrogram. */
+    juce::uint64 _lastSpectrogramGeneration = 0;
+    /** Goniometer and correlation meter for the output, below the buttons. */
+    StereoScopeView _stereoScopeView{ _audioProcessor.getStereoScope() };
+#if EVILAUDIO_PAINT_PROFILING
+    /** Live paint timings of the instrumented components, over the whole editor. */
+    EvilAudio_PaintProfilerOverlay _paintProfilerOverlay;
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParametricEqualiserEditor)
 
@@ -13,6 +13,16 @@ namespace IDs
     juce::String editor{ "editor" };
     juce::String sizeX{ "size-x" };
     juce::String sizeY{ "size-y" };
+    juce::String analyser{ "analyser" };
+    juce::String fftOrder{ "fft-order" };
+    juce::String overlap{ "overlap" };
+    juce::String window{ "window" };
+    juce::String averaging{ "averaging" };
+    juce::String boxcarFrames{ "boxcar-frames" };
+    juce::String averagingTime{ "averaging-time" };
+    juce::String peakDecay{ "peak-decay" };
+    juce::String smoothing{ "smoothing" };
+    juce::String channels{ "channels" };
 }
 
 std::vector<ParametricEqualiserProcessor::Band> createDefaultBands()
@@ -115,18 +125,10 @@ ParametricEqualiserProcessor::ParametricEqualiserProcessor() :
     ),
     _parameters(*this, &_undo, "PARAMS", createParameterLayout())
 {
-    _frequencies.resize(300);
-    for (size_t i = 0; i < _frequencies.size(); ++i) {
-        _frequencies[i] = 20.0 * std::pow(2.0, i / 30.0);
-    }
-    _magnitudes.resize(_frequencies.size());
-
     _bands = createDefaultBands();
 
     for (size_t i = 0; i < _bands.size(); ++i)
     {
-        _bands[i].magnitudes.resize(_frequencies.size(), 1.0);
-
         _parameters.addParameterListener(getTypeParamName(i), this);
         _parameters.addParameterListener(getFrequencyParamName(i), this);
         _parameters.addParameterListener(getQualityParamName(i), this);
@@ -142,34 +144,138 @@ ParametricEqualiserProcessor::~ParametricEqualiserProcessor() {
 
 //==============================================================================
 
-bool ParametricEqualiserProcessor::checkForNewAnalyserData()
+ParametricEqualiserProcessor::AnalyserSubscription::AnalyserSubscription(ParametricEqualiserProcessor& processor)
+    : _processor(processor)
+{
+    _processor._inputAnalyser.addSubscriber();
+    _processor._outputAnalyser.addSubscriber();
+}
+
+ParametricEqualiserProcessor::AnalyserSubscription::~AnalyserSubscription()
+{
+    setVisible(false);
+    _processor._inputAnalyser.removeSubscriber();
+    _processor._outputAnalyser.removeSubscriber();
+}
+
+void ParametricEqualiserProcessor::AnalyserSubscription::setVisible(bool shouldBeVisible)
+{
+    if (_visible == shouldBeVisible)
+        return;
+
+    _visible = shouldBeVisible;
+    _processor._inputAnalyser.setSubscriberVisible(_visible);
+    _processor._outputAnalyser.setSubscriberVisible(_visible);
+}
+
+//==============================================================================
+
+ParametricEqualiserProcessor::MeasurementSubscription::MeasurementSubscription(ParametricEqualiserProcessor& processor)
+    : _processor(processor)
+{
+    _processor._transferAnalyser.addSubscriber();
+}
+
+ParametricEqualiserProcessor::MeasurementSubscription::~MeasurementSubscription()
+{
+    setVisible(false);
+    _processor._transferAnalyser.removeSubscriber();
+}
+
+void ParametricEqualiserProcessor::MeasurementSubscription::setVisible(bool shouldBeVisible)
+{
+    if (_visible == shouldBeVisible)
+        return;
+
+    _visible = shouldBeVisible;
+    _processor._transferAnalyser.setSubscriberVisible(_visible);
+}
+
+//==============================================================================
+
+juce::uint64 ParametricEqualiserProcessor::getAnalyserGeneration() const
+{
+    return _inputAnalyser.getFrameGeneration() + _outputAnalyser.getFrameGeneration()
+         + _transferAnalyser.getFrameGeneration();
+}
+
+juce::uint64 ParametricEqualiserProcessor::getAnalyserGeneration(bool input) const
+{
+    return input ? _inputAnalyser.getFrameGeneration() : _outputAnalyser.getFrameGeneration();
+}
+
+const SpectrumFrame* ParametricEqualiserProcessor::getLatestAnalyserFrame(bool input)
 {
-    return _inputAnalyser.checkForNewData() || _outputAnalyser.checkForNewData();
+    return input ? _inputAnalyser.getLatestFrame() : _outputAnalyser.getLatestFrame();
+}
+
+juce::uint64 ParametricEqualiserProcessor::getAnalyserOverrunCount(bool input) const
+{
+    return input ? _inputAnalyser.getOverrunCount() : _outputAnalyser.getOverrunCount();
+}
+
+juce::uint64 ParametricEqualiserProcessor::getAnalyserDroppedSampleCount(bool input) const
+{
+    return input ? _inputAnalyser.getDroppedSampleCount() : _outputAnalyser.getDroppedSampleCount();
+}
+
+void ParametricEqualiserProcessor::setAnalyserSettings(const AnalyserSettings& settings)
+{
+    _inputAnalyser.setSettings(settings);
+    _outputAnalyser.setSettings(settings);
+    _transferAnalyser.setSettings(settings);
+}
+
+AnalyserSettings ParametricEqualiserProcessor::getAnalyserSettings() const
+{
+    return _inputAnalyser.getSettings();
 }
 
 void ParametricEqualiserProcessor::createFrequencyPlot(juce::Path& p, 
-                                                       const std::vector<double>& mags, 
+                                                       int band, 
                                                        const juce::Rectangle<int> bounds, 
-                                                       float pixelsPerDouble) {
-    p.startNewSubPath(float(bounds.getX()), mags[0] > 0 ? float(bounds.getCentreY() - pixelsPerDouble * std::log(mags[0]) / std::log(2.0)) : bounds.getBottom());
-    const auto xFactor = static_cast<double> (bounds.getWidth()) / _frequencies.size();
-    for (size_t i = 1; i < _frequencies.size(); ++i)
+                                                       float maxDecibels) {
+    std::vector<juce::dsp::IIR::Coefficients<float>::Ptr> filters;
+    double gain = 1.0;
     {
-        p.lineTo(float(bounds.getX() + i * xFactor),
-            float(mags[i] > 0 ? bounds.getCentreY() - pixelsPerDouble * std::log(mags[i]) / std::log(2.0) : bounds.getBottom()));
+        juce::ScopedLock processLock(getCallbackLock());
+        if (juce::isPositiveAndBelow(band, _bands.size()))
+        {
+            filters.push_back(_bands[size_t(band)].coefficients);
+        }
+        else
+        {
+            gain = _filterChain.get<6>().getGainLinear();
+            for (size_t i = 0; i < _bands.size(); ++i)
+                if (juce::isPositiveAndBelow(_soloedBand, _bands.size()) ? int(i) == _soloedBand : _bands[i].active)
+                    filters.push_back(_bands[i].coefficients);
+        }
     }
+
+    // Before prepareToPlay() there are no coefficients yet, and the curves are flat.
+    _responseCurve.setGrid(bounds.getWidth(), _sampleRate > 0 ? _sampleRate : 48000.0, 20.0f, 10.0f);
+    _responseCurve.createPath(p, filters, gain, bounds.toFloat(), maxDecibels);
 };
 
 void ParametricEqualiserProcessor::createAnalyserPlot(juce::Path& p, 
                                                       const juce::Rectangle<int> bounds, 
                                                       float minFreq, 
-                                                      bool input) {
+                                                      bool input,
+                                                      bool secondStream) {
     if (input)
-        _inputAnalyser.createPath(p, bounds.toFloat(), minFreq);
+        _inputAnalyser.createPath(p, bounds.toFloat(), minFreq, secondStream);
     else
-        _outputAnalyser.createPath(p, bounds.toFloat(), minFreq);
+        _outputAnalyser.createPath(p, bounds.toFloat(), minFreq, secondStream);
 };  
 
+void ParametricEqualiserProcessor::createMeasuredResponsePlot(juce::Path& response,
+                                                              juce::Path& coherence,
+                                                              const juce::Rectangle<int> bounds,
+                                                              float minFreq,
+                                                              float maxDecibels) {
+    _transferAnalyser.createPaths(response, coherence, bounds.toFloat(), minFreq, maxDecibels);
+}
+
 ParametricEqualiserProcessor::Band* ParametricEqualiserProcessor::getBand(size_t index)
 {
     if (juce::isPositiveAndBelow(index, _bands.size()))
@@ -227,10 +333,6 @@ size_t ParametricEqualiserProcessor::getNumBands() const
     return _bands.size();
 }
 
-const std::vector<double>& ParametricEqualiserProcessor::getMagnitudes() {
-    return _magnitudes;
-}
-
 juce::String ParametricEqualiserProcessor::getTypeParamName(size_t index)
 {
     return getBandID(index) + "-" + paramType;
@@ -277,7 +379,7 @@ juce::StringArray ParametricEqualiserProcessor::getFilterTypeNames()
 void ParametricEqualiserProcessor::parameterChanged(const juce::String& parameter, float newValue) {
     if (parameter == paramOutput) {
         _filterChain.get<6>().setGainLinear(newValue);
-        updatePlots();
+        markResponseChanged();
         return;
     }
     int index = getBandIndexFromID(parameter);
@@ -365,13 +467,12 @@ void ParametricEqualiserProcessor::updateBand(const size_t index) {
                     *_filterChain.get<4>().state = *newCoefficients;
                 else if (index == 5)
                     *_filterChain.get<5>().state = *newCoefficients;
+                _bands[index].coefficients = newCoefficients;
             }
-            newCoefficients->getMagnitudeForFrequencyArray(_frequencies.data(),
-                _bands[index].magnitudes.data(),
-                _frequencies.size(), _sampleRate);
+            // The response is only worked out when a view asks for it, once per frame.
+            markResponseChanged(index);
         }
         updateBypassedStates();
-        updatePlots();
     }
 };  
     
@@ -392,23 +493,32 @@ void ParametricEqualiserProcessor::updateBypassedStates() {
         _filterChain.setBypassed<4>(!_bands[4].active);
         _filterChain.setBypassed<5>(!_bands[5].active);
     }
-    updatePlots();
+    markResponseChanged();
 };
 
-void ParametricEqualiserProcessor::updatePlots() {
-    auto gain = _filterChain.get<6>().getGainLinear();
-    std::fill(_magnitudes.begin(), _magnitudes.end(), gain);
+void ParametricEqualiserProcessor::markResponseChanged(size_t band) {
+    _dirtyBands.fetch_or(juce::uint32(1) << band);
+    markResponseChanged();
+}
 
-    if (juce::isPositiveAndBelow(_soloedBand, _bands.size())) {
-        juce::FloatVectorOperations::multiply(_magnitudes.data(), _bands[size_t(_soloedBand)].magnitudes.data(), static_cast<int> (_magnitudes.size()));
-    }
-    else
+void ParametricEqualiserProcessor::markResponseChanged() {
+    ++_responseGeneration;
+}
+
+juce::uint64 ParametricEqualiserProcessor::getResponseGeneration() const noexcept {
+    return _responseGeneration.load();
+}
+
+void ParametricEqualiserProcessor::updateResponses() {
+    const auto dirtyBands = _dirtyBands.exchange(0);
+
+    for (size_t i = 0; i < _bands.size(); ++i)
     {
-        for (size_t i = 0; i < _bands.size(); ++i)
-            if (_bands[i].active)
-                juce::FloatVectorOperations::multiply(_magnitudes.data(), _bands[i].magnitudes.data(), static_cast<int>(_magnitudes.size()));
+        if ((dirtyBands & (juce::uint32(1) << i)) == 0)
+            continue;
+
+        ++_bands[i].responseVersion;
     }
-    sendChangeMessage();
 };
 
 
@@ -433,17 +543,18 @@ void  ParametricEqualiserProcessor::prepareToPlay(double newSampleRate, int newS
     }
     _filterChain.get<6>().setGainLinear(*_parameters.getRawParameterValue(paramOutput));
 
-    updatePlots();
+    markResponseChanged();
 
     _filterChain.prepare(spec);
 
     _inputAnalyser.setupAnalyser(int(_sampleRate), float(_sampleRate));
     _outputAnalyser.setupAnalyser(int(_sampleRate), float(_sampleRate));
+    _transferAnalyser.setupAnalyser(int(_sampleRate), _sampleRate);
+    _stereoScope.setSampleRate(_sampleRate);
 }
 
 void  ParametricEqualiserProcessor::releaseResources() {
-    _inputAnalyser.stopThread(1000);
-    _outputAnalyser.stopThread(1000);
+    // The analysers are owned by their subscribers' lifetimes, not by playback.
 }
 
 void ParametricEqualiserProcessor::processBlock(juce::AudioBuffer<float>& buffer, 
@@ -451,10 +562,9 @@ void ParametricEqualiserProcessor::processBlock(juce::AudioBuffer<float>& buffer
     juce::ScopedNoDenormals noDenormals;
     juce::ignoreUnused(midiMessages);
 
-    // Always feed data to the analysers regardless of whether the editor is open or not.
-    //if (getActiveEditor() != nullptr) {
+    // The analysers return straight away unless a view has subscribed to them.
     _inputAnalyser.addAudioData(buffer, 0, getTotalNumInputChannels());
-    //}
+    _transferAnalyser.addInputData(buffer, 0, getTotalNumInputChannels());
 
     if (_wasBypassed) {
         _filterChain.reset();
@@ -465,10 +575,9 @@ void ParametricEqualiserProcessor::processBlock(juce::AudioBuffer<float>& buffer
     juce::dsp::ProcessContextReplacing<float> context(ioBuffer);
     _filterChain.process(context);
 
-    // Always feed data to the analysers regardless of whether the editor is open or not.
-    // if (getActiveEditor() != nullptr) {
     _outputAnalyser.addAudioData(buffer, 0, getTotalNumOutputChannels());
-    //}
+    _stereoScope.addAudioData(buffer, 0, getTotalNumOutputChannels());
+    _transferAnalyser.addOutputData(buffer, 0, getTotalNumOutputChannels());
 }
 
 bool ParametricEqualiserProcessor::isBusesLayoutSupported(const BusesLayout& busesLayout) const { 
@@ -527,6 +636,18 @@ void  ParametricEqualiserProcessor::getStateInformation(juce::MemoryBlock& destD
     editorProperties.setProperty(IDs::sizeX, _editorSize.x, nullptr);
     editorProperties.setProperty(IDs::sizeY, _editorSize.y, nullptr);
 
+    const auto settings = getAnalyserSettings();
+    auto analyserProperties = state.getOrCreateChildWithName(IDs::analyser, nullptr);
+    analyserProperties.setProperty(IDs::fftOrder, settings.fftOrder, nullptr);
+    analyserProperties.setProperty(IDs::overlap, settings.overlap, nullptr);
+    analyserProperties.setProperty(IDs::window, int(settings.window), nullptr);
+    analyserProperties.setProperty(IDs::averaging, int(settings.averaging), nullptr);
+    analyserProperties.setProperty(IDs::boxcarFrames, settings.boxcarFrames, nullptr);
+    analyserProperties.setProperty(IDs::averagingTime, settings.averagingTimeSeconds, nullptr);
+    analyserProperties.setProperty(IDs::peakDecay, settings.peakDecayDbPerSecond, nullptr);
+    analyserProperties.setProperty(IDs::smoothing, settings.octaveFraction, nullptr);
+    analyserProperties.setProperty(IDs::channels, int(settings.channelMode), nullptr);
+
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -546,6 +667,28 @@ void ParametricEqualiserProcessor::setStateInformation(const void* data, int siz
                 if (auto* thisEditor = getActiveEditor())
                     thisEditor->setSize(_editorSize.x, _editorSize.y);
             }
+            auto analyser = _parameters.state.getChildWithName(IDs::analyser);
+            if (analyser.isValid())
+            {
+                AnalyserSettings settings;
+                settings.fftOrder = juce::jlimit(AnalyserSettings::minFftOrder, AnalyserSettings::maxFftOrder,
+                                                 int(analyser.getProperty(IDs::fftOrder, settings.fftOrder)));
+                settings.overlap = analyser.getProperty(IDs::overlap, settings.overlap);
+                settings.window = AnalyserSettings::WindowingMethod(juce::jlimit(0, int(AnalyserSettings::WindowingMethod::numWindowingMethods) - 1,
+                    int(analyser.getProperty(IDs::window, int(settings.window)))));
+                settings.averaging = AnalyserSettings::Averaging(juce::jlimit(0, int(AnalyserSettings::Averaging::peakHold),
+                    int(analyser.getProperty(IDs::averaging, int(settings.averaging)))));
+                settings.boxcarFrames = juce::jlimit(1, AnalyserSettings::maxBoxcarFrames,
+                                                     int(analyser.getProperty(IDs::boxcarFrames, settings.boxcarFrames)));
+                settings.averagingTimeSeconds = analyser.getProperty(IDs::averagingTime, settings.averagingTimeSeconds);
+                settings.peakDecayDbPerSecond = juce::jlimit(0.0f, AnalyserSettings::maxPeakDecayDbPerSecond,
+                                                             float(analyser.getProperty(IDs::peakDecay, settings.peakDecayDbPerSecond)));
+                settings.octaveFraction = juce::jlimit(0, AnalyserSettings::maxOctaveFraction,
+                                                       int(analyser.getProperty(IDs::smoothing, settings.octaveFraction)));
+                settings.channelMode = AnalyserSettings::ChannelMode(juce::jlimit(0, int(AnalyserSettings::ChannelMode::midSide),
+                    int(analyser.getProperty(IDs::channels, int(settings.channelMode)))));
+                setAnalyserSettings(settings);
+            }
         }
     }
 }
@@ -2,11 +2,14 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "Analyser.h"
+#include "EqualiserTables.h"
+#include "FrequencyResponseCurve.h"
+#include "StereoScope.h"
+#include "TransferFunctionAnalyser.h"
 
 class ParametricEqualiserProcessor : 
     public juce::AudioProcessor,
-    public juce::AudioProcessorValueTreeState::Listener,
-    public juce::ChangeBroadcaster
+    public juce::AudioProcessorValueTreeState::Listener
 {
 public:
     enum FilterType
@@ -62,16 +65,95 @@ public:
         float        quality = 1.0f;
         float        gain = 1.0f;
         bool         active = true;
-        std::vector<double> magnitudes;
+        /** Incremented whenever the response or active change, so views can skip unchanged bands. */
+        juce::uint32 responseVersion = 0;
+        /** The coefficients last handed to the filter, guarded by the callback lock. */
+        juce::dsp::IIR::Coefficients<float>::Ptr coefficients;
+    };
+
+    /**
+     * Keeps the input and output analysers running for as long as it exists.
+     *
+     * Views that display the spectrum hold one of these; while none exist the analysers
+     * are freed, the audio thread skips the analyser FIFO copy and no FFTs are performed.
+     * Create and destroy on the message thread.
+     */
+    class AnalyserSubscription
+    {
+    public:
+        explicit AnalyserSubscription(ParametricEqualiserProcessor& processor);
+        ~AnalyserSubscription();
+
+        /** Visible subscriptions get their analysis scheduled ahead of hidden ones. */
+        void setVisible(bool shouldBeVisible);
+
+    private:
+        ParametricEqualiserProcessor& _processor;
+        bool _visible = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserSubscription)
+    };
+
+    /**
+     * Keeps the transfer-function measurement running for as long as it exists, in the
+     * same way as AnalyserSubscription. Create and destroy on the message thread.
+     */
+    class MeasurementSubscription
+    {
+    public:
+        explicit MeasurementSubscription(ParametricEqualiserProcessor& processor);
+        ~MeasurementSubscription();
+
+        void setVisible(bool shouldBeVisible);
+
+    private:
+        ParametricEqualiserProcessor& _processor;
+        bool _visible = false;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeasurementSubscription)
     };
 
 public:
     ParametricEqualiserProcessor();
     ~ParametricEqualiserProcessor() override;
 
-    bool checkForNewAnalyserData();
-    void createFrequencyPlot(juce::Path& p, const std::vector<double>& mags, const juce::Rectangle<int> bounds, float pixelsPerDouble);
-    void createAnalyserPlot(juce::Path& p, const juce::Rectangle<int> bounds, float minFreq, bool input);
+    /**
+     * Returns a counter that increases every time either analyser publishes a new
+     * spectrum frame. Compare it with the last value seen to decide whether to repaint.
+     */
+    juce::uint64 getAnalyserGeneration() const;
+    /** Returns the number of frames published by the input or output analyser alone. */
+    juce::uint64 getAnalyserGeneration(bool input) const;
+    /** Returns the newest input or output spectrum, see Analyser::getLatestFrame(). */
+    const SpectrumFrame* getLatestAnalyserFrame(bool input);
+    /** Returns how often the input or output analysis fell behind and had to skip audio. */
+    juce::uint64 getAnalyserOverrunCount(bool input) const;
+    /** Returns how many samples the input or output analysis has skipped in total. */
+    juce::uint64 getAnalyserDroppedSampleCount(bool input) const;
+    /** Applies new STFT settings to both analysers. Safe to call while they are running. */
+    void setAnalyserSettings(const AnalyserSettings& settings);
+    AnalyserSettings getAnalyserSettings() const;
+    /**
+     * Builds a path through the response of one band, or of the whole equaliser (the active
+     * or soloed bands and the output gain) if band is negative. Message thread only.
+     *
+     * The response is evaluated at the resolution of the plot, with extra points around
+     * narrow peaks and notches; +maxDecibels is at the top of bounds, -maxDecibels at the bottom.
+     */
+    void createFrequencyPlot(juce::Path& p, int band, const juce::Rectangle<int> bounds, float maxDecibels);
+    /**
+     * Builds a path through the input or output spectrum. secondStream selects the right or
+     * side channel in the two-stream channel modes; the path is empty in the others.
+     */
+    void createAnalyserPlot(juce::Path& p, const juce::Rectangle<int> bounds, float minFreq, bool input, bool secondStream = false);
+    /**
+     * Builds paths through the measured response (on the same +/- maxDecibels scale as the
+     * frequency plot) and its coherence (0 to 1). Empty unless a MeasurementSubscription exists.
+     */
+    void createMeasuredResponsePlot(juce::Path& response, juce::Path& coherence,
+                                    const juce::Rectangle<int> bounds, float minFreq, float maxDecibels);
+    /** Returns the output tap for the phase views; subscribe to it to start the capture. */
+    StereoScope& getStereoScope() noexcept { return _stereoScope; }
 
     Band* getBand(size_t index);
     bool getBandSolo(int index) const;
@@ -79,10 +161,23 @@ public:
     juce::Colour getBandColour(size_t index) const;
     int getBandIndexFromID(juce::String paramID);
     size_t getNumBands() const;
-    const std::vector<double>& getMagnitudes();
+    /**
+     * Returns a counter that changes whenever a parameter, the solo state or the sample rate
+     * changes anything the response plots show. Safe to call from any thread.
+     *
+     * Views poll it once per display frame and call updateResponses() when it has moved, so
+     * any number of parameter changes in between cost a single update.
+     */
+    juce::uint64 getResponseGeneration() const noexcept;
+    /**
+     * Bumps the responseVersion of the bands that changed since the last call. Message
+     * thread only.
+     */
+    void updateResponses();
 
     void setBandSolo(int index);
 
+
     // Implement all pure virtual methods from juce::AudioProcessor
     const juce::String getName() const override;
     void prepareToPlay(double, int) override;
@@ -113,14 +208,20 @@ public:
 private:
     void updateBand(const size_t index);
     void updateBypassedStates();
-    void updatePlots();
+    void markResponseChanged(size_t band);
+    void markResponseChanged();
 
     juce::AudioProcessorValueTreeState _parameters;
     juce::UndoManager _undo;
 
+    juce::SharedResourcePointer<EqualiserTables> _sharedTables;
+
     std::vector<Band> _bands;
-    std::vector<double> _frequencies;
-    std::vector<double> _magnitudes;
+    /** Evaluates the response curves for createFrequencyPlot(). */
+    FrequencyResponseCurve _responseCurve;
+    /** One bit per band whose response changed since updateResponses() was last called. */
+    std::atomic<juce::uint32> _dirtyBands{ 0 };
+    std::atomic<juce::uint64> _responseGeneration{ 0 };
 
     double _sampleRate = 0;
     int _soloedBand = -1;
@@ -130,8 +231,10 @@ private:
     using Gain = juce::dsp::Gain<float>;
     juce::dsp::ProcessorChain<FilterBand, FilterBand, FilterBand, FilterBand, FilterBand, FilterBand, Gain> _filterChain;
 
-    Analyser<float> _inputAnalyser;
-    Analyser<float> _outputAnalyser;
+    Analyser<float> _inputAnalyser{ getCallbackLock() };
+    Analyser<float> _outputAnalyser{ getCallbackLock() };
+    TransferFunctionAnalyser _transferAnalyser{ getCallbackLock() };
+    StereoScope _stereoScope{ getCallbackLock() };
 
     juce::Point<int> _editorSize = { 900, 500 };
 
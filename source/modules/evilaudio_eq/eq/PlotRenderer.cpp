@@ -0,0 +1,137 @@
+#include "PlotRenderer.h"
+
+PlotRenderer::PlotRenderer()
+    : juce::Thread("Plot renderer")
+{
+    startThread(juce::Thread::Priority::normal);
+}
+
+PlotRenderer::~PlotRenderer()
+{
+    cancelPendingUpdate();
+    signalThreadShouldExit();
+    notify();
+    stopThread(1000);
+}
+
+void PlotRenderer::submit(std::vector<Stroke>&& strokes, juce::Rectangle<int> area, float scale, juce::Rectangle<int> dirty)
+{
+    {
+        const juce::ScopedLock sl(_sceneLock);
+        // A scene that is dropped still changed the screen, so its dirty area carries over.
+        _pendingScene.dirty = _hasPendingScene ? _pendingScene.dirty.getUnion(dirty) : dirty;
+        _pendingScene.strokes = std::move(strokes);
+        _pendingScene.area = area;
+        _pendingScene.scale = scale;
+        _pendingScene.sequence = ++_submittedScenes;
+        _hasPendingScene = true;
+    }
+    notify();
+}
+
+void PlotRenderer::draw(juce::Graphics& g)
+{
+    const juce::ScopedLock sl(_frontLock);
+    if (_front.image.isValid())
+        g.drawImage(_front.image, _front.area.toFloat());
+}
+
+bool PlotRenderer::waitForLatestScene(int timeoutMilliseconds)
+{
+    juce::uint64 latest = 0;
+    {
+        const juce::ScopedLock sl(_sceneLock);
+        latest = _submittedScenes;
+    }
+
+    const auto deadline = juce::Time::getMillisecondCounter() + juce::uint32(juce::jmax(0, timeoutMilliseconds));
+    while (_renderedScenes.load() < latest)
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+        if (now >= deadline)
+            return false;
+
+        _sceneRendered.wait(double(deadline - now));
+    }
+    return true;
+}
+
+void PlotRenderer::run()
+{
+    Scene scene;
+
+    while (! threadShouldExit())
+    {
+        {
+            const juce::ScopedLock sl(_sceneLock);
+            if (_hasPendingScene)
+            {
+                // Swapping keeps both vectors' storage alive, so steady state doesn't allocate.
+                std::swap(scene, _pendingScene);
+                _hasPendingScene = false;
+            }
+            else
+            {
+                scene.strokes.clear();
+            }
+        }
+
+        if (scene.area.isEmpty())
+        {
+            // Nothing to draw for an empty area, but it still counts as done.
+            if (scene.sequence > _renderedScenes.load())
+            {
+                _renderedScenes = scene.sequence;
+                _sceneRendered.signal();
+            }
+            wait(-1);
+            continue;
+        }
+
+        render(scene);
+        scene.area = {};
+        _renderedScenes = scene.sequence;
+        _sceneRendered.signal();
+        triggerAsyncUpdate();
+    }
+}
+
+void PlotRenderer::render(const Scene& scene)
+{
+    const auto width = juce::jmax(1, juce::roundToInt(scene.area.getWidth() * scene.scale));
+    const auto height = juce::jmax(1, juce::roundToInt(scene.area.getHeight() * scene.scale));
+
+    if (! _back.image.isValid() || _back.image.getWidth() != width || _back.image.getHeight() != height)
+        _back.image = juce::Image(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+    else
+        _back.image.clear(_back.image.getBounds());
+
+    _back.area = scene.area;
+
+    {
+        juce::Graphics g(_back.image);
+        g.addTransform(juce::AffineTransform::translation(-scene.area.getPosition().toFloat()).scaled(scene.scale));
+
+        for (const auto& stroke : scene.strokes)
+        {
+            g.setColour(stroke.colour);
+            g.strokePath(stroke.path, juce::PathStrokeType(stroke.thickness));
+        }
+    }
+
+    const juce::ScopedLock sl(_frontLock);
+    std::swap(_front, _back);
+    _readyDirty = _readyDirty.getUnion(scene.dirty);
+}
+
+void PlotRenderer::handleAsyncUpdate()
+{
+    juce::Rectangle<int> dirty;
+    {
+        const juce::ScopedLock sl(_frontLock);
+        std::swap(dirty, _readyDirty);
+    }
+
+    if (onFrameReady != nullptr)
+        onFrameReady(dirty);
+}
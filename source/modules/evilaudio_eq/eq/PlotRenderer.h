@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/**
+ *  Rasterises the dynamic layers of a plot (analyser spectra, response curves) on a
+ *  background thread, so the message thread only has to blit the result.
+ *
+ *  The message thread builds the paths, which is cheap, and submit()s them as a scene.
+ *  The render thread strokes the newest scene into a software image and swaps it with
+ *  the one being displayed; a scene that is replaced before the thread got to it is
+ *  simply dropped. Only software images are used, so no GPU is needed.
+ */
+class PlotRenderer : private juce::Thread,
+                     private juce::AsyncUpdater
+{
+public:
+    /** One path to stroke. */
+    struct Stroke
+    {
+        juce::Path path;
+        juce::Colour colour;
+        float thickness = 1.0f;
+    };
+
+    PlotRenderer();
+    ~PlotRenderer() override;
+
+    /**
+     * Hands over the layers to draw, replacing any scene that hasn't been started yet.
+     * Message thread only.
+     *
+     * @param strokes  The paths in drawing order, in component coordinates.
+     * @param area     The part of the component the image covers.
+     * @param scale    Physical pixels per component pixel.
+     * @param dirty    The part of the component that changed since the previous scene.
+     */
+    void submit(std::vector<Stroke>&& strokes, juce::Rectangle<int> area, float scale, juce::Rectangle<int> dirty);
+
+    /** Draws the newest finished image over the area it was rendered for. Message thread only. */
+    void draw(juce::Graphics& g);
+
+    /**
+     * Blocks until the last scene submitted has been rendered, so that draw() shows it.
+     * Meant for benchmarks and tests; the editor itself never waits.
+     *
+     * @return false if it wasn't done within the timeout.
+     */
+    bool waitForLatestScene(int timeoutMilliseconds);
+
+    /**
+     * Called on the message thread whenever a new image is ready to be drawn, with the
+     * union of the dirty areas of the scenes rendered since the previous call.
+     */
+    std::function<void(juce::Rectangle<int>)> onFrameReady;
+
+private:
+    struct Scene
+    {
+        std::vector<Stroke> strokes;
+        juce::Rectangle<int> area;
+        float scale = 1.0f;
+        juce::Rectangle<int> dirty;
+        /** Counts the scenes submitted, so waitForLatestScene() can tell when this one is done. */
+        juce::uint64 sequence = 0;
+    };
+
+    struct Frame
+    {
+        juce::Image image;
+        juce::Rectangle<int> area;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+    void render(const Scene& scene);
+
+    juce::CriticalSection _sceneLock;
+    Scene _pendingScene;
+    bool _hasPendingScene = false;
+    juce::uint64 _submittedScenes = 0;
+    std::atomic<juce::uint64> _renderedScenes{ 0 };
+    juce::WaitableEvent _sceneRendered;
+
+    /** The image being drawn into by the render thread, and the one being displayed. */
+    Frame _back;
+    Frame _front;
+    /** Dirty areas of the images swapped in since onFrameReady was last called. */
+    juce::Rectangle<int> _readyDirty;
+    juce::CriticalSection _frontLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlotRenderer)
+};
@@ -0,0 +1,82 @@
+#include "Spectrogram.h"
+
+Spectrogram::Spectrogram()
+{
+    // Dark blue through purple and red to yellow, so loud components stand out against the plot.
+    juce::ColourGradient gradient(juce::Colour(0xff000000), 0.0f, 0.0f, juce::Colour(0xffffffc0), 1.0f, 0.0f, false);
+    gradient.addColour(0.25, juce::Colour(0xff1a0a4a));
+    gradient.addColour(0.5, juce::Colour(0xff8a1c6c));
+    gradient.addColour(0.75, juce::Colour(0xfff0602a));
+    gradient.addColour(0.9, juce::Colour(0xfffcc838));
+
+    for (int i = 0; i < numColours; ++i)
+        _colours[size_t(i)] = gradient.getColourAtPosition(double(i) / (numColours - 1)).getPixelARGB();
+}
+
+void Spectrogram::setSize(int width, int height)
+{
+    width = juce::jmax(0, width);
+    height = juce::jmax(0, height);
+
+    if (_image.isValid() && _image.getWidth() == width && _image.getHeight() == height)
+        return;
+
+    _image = width > 0 && height > 0 ? juce::Image(juce::Image::ARGB, width, height, false) : juce::Image();
+    _columnValues.assign(size_t(width), 0.0f);
+    clear();
+}
+
+void Spectrogram::clear()
+{
+    _newestRow = 0;
+    if (_image.isValid())
+        _image.clear(_image.getBounds(), juce::Colour(_colours[0].getInARGBMaskOrder()));
+}
+
+void Spectrogram::addFrame(const SpectrumFrame& frame, float minFrequency)
+{
+    if (! _image.isValid() || frame.magnitudes.empty())
+        return;
+
+    const auto width = _image.getWidth();
+    _columnMap.update(width, frame.sampleRate, frame.fftSize, minFrequency, 10.0f);
+    _columnMap.mapColumns(frame.magnitudes.data(), _columnValues.data());
+
+    _newestRow = (_newestRow == 0 ? _image.getHeight() : _newestRow) - 1;
+
+    const juce::Image::BitmapData row(_image, 0, _newestRow, width, 1, juce::Image::BitmapData::writeOnly);
+    jassert(row.pixelFormat == juce::Image::ARGB);
+
+    const auto scale = (numColours - 1) / (ceilingDecibels - floorDecibels);
+    const auto numColumns = _columnMap.getNumColumns();
+
+    for (int x = 0; x < width; ++x)
+    {
+        auto& pixel = *reinterpret_cast<juce::PixelARGB*>(row.getPixelPointer(x, 0));
+
+        // Columns above Nyquist have nothing to show.
+        if (x >= numColumns)
+        {
+            pixel = _colours[0];
+            continue;
+        }
+
+        const auto decibels = juce::Decibels::gainToDecibels(_columnValues[size_t(x)], floorDecibels);
+        pixel = _colours[size_t(juce::jlimit(0, numColours - 1, int((decibels - floorDecibels) * scale)))];
+    }
+}
+
+void Spectrogram::draw(juce::Graphics& g, juce::Point<int> topLeft) const
+{
+    if (! _image.isValid())
+        return;
+
+    // The newest row and everything older that follows it in the image go at the top,
+    // the rows that have wrapped round to the start of the image underneath.
+    const auto width = _image.getWidth();
+    const auto rowsToEnd = _image.getHeight() - _newestRow;
+
+    g.drawImage(_image, topLeft.x, topLeft.y, width, rowsToEnd, 0, _newestRow, width, rowsToEnd);
+    if (_newestRow > 0)
+        g.drawImage(_image, topLeft.x, topLeft.y + rowsToEnd, width, _newestRow, 0, 0, width, _newestRow);
+}
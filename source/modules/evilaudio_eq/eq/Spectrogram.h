@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include "Analyser.h"
+#include "SpectrumColumnMap.h"
+
+/**
+ *  A scrolling waterfall of analyser frames, drawn behind the frequency plot.
+ *
+ *  Frequency runs along the x axis on the same log scale as the plot and time runs down,
+ *  newest at the top. The history lives in an image used as a ring of rows: each new frame
+ *  only writes one row, through a precomputed colour table, and drawing is two blits either
+ *  side of the newest row. Neither cost depends on how long the spectrogram has been running.
+ *
+ *  Message thread only.
+ */
+class Spectrogram
+{
+public:
+    Spectrogram();
+
+    /** Resizes the history to one pixel per row and column. Clears it if the size changes. */
+    void setSize(int width, int height);
+    /** Clears the history to the colour of silence. */
+    void clear();
+
+    /**
+     * Writes a frame as the newest row, scrolling the older ones down.
+     *
+     * @param minFrequency  Frequency at the left edge; the image spans 10 octaves from there.
+     */
+    void addFrame(const SpectrumFrame& frame, float minFrequency);
+
+    /** Draws the history with its top left corner at topLeft, newest row first. */
+    void draw(juce::Graphics& g, juce::Point<int> topLeft) const;
+
+    /** The range mapped onto the colour table; anything outside it is clipped. */
+    static constexpr float floorDecibels = -100.0f;
+    static constexpr float ceilingDecibels = 0.0f;
+
+private:
+    static constexpr int numColours = 256;
+
+    juce::Image _image;
+    /** Row holding the newest frame. */
+    int _newestRow = 0;
+    SpectrumColumnMap _columnMap;
+    std::vector<float> _columnValues;
+    std::array<juce::PixelARGB, numColours> _colours;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Spectrogram)
+};
@@ -0,0 +1,70 @@
+#include "SpectrumColumnMap.h"
+
+bool SpectrumColumnMap::update(int numColumns, double sampleRate, int fftSize, float minFrequency, float numOctaves)
+{
+    if (numColumns == _numColumns && sampleRate == _sampleRate && fftSize == _fftSize
+        && minFrequency == _minFrequency && numOctaves == _numOctaves)
+        return false;
+
+    _numColumns = numColumns;
+    _sampleRate = sampleRate;
+    _fftSize = fftSize;
+    _minFrequency = minFrequency;
+    _numOctaves = numOctaves;
+    _columns.clear();
+
+    const auto numBins = fftSize / 2;
+    if (numColumns <= 0 || sampleRate <= 0.0 || numBins < 2)
+        return true;
+
+    const auto binsPerHertz = fftSize / sampleRate;
+    const auto frequencyAt = [&](double column)
+    {
+        return minFrequency * std::pow(2.0, numOctaves * column / numColumns);
+    };
+    const auto firstBinFrom = [&](double column)
+    {
+        return juce::jlimit(0, numBins, int(std::ceil(frequencyAt(column) * binsPerHertz)));
+    };
+
+    _columns.reserve(size_t(numColumns));
+
+    for (int c = 0; c < numColumns; ++c)
+    {
+        Column column;
+        column.firstBin = firstBinFrom(c);
+        column.endBin = firstBinFrom(c + 1);
+
+        // Nothing above Nyquist to draw.
+        if (column.firstBin >= numBins)
+            break;
+
+        if (column.endBin == column.firstBin)
+        {
+            const auto position = juce::jlimit(0.0, double(numBins - 1), frequencyAt(c + 0.5) * binsPerHertz);
+            column.firstBin = juce::jmin(int(position), numBins - 2);
+            column.endBin = column.firstBin;
+            column.fraction = float(position - column.firstBin);
+        }
+        _columns.push_back(column);
+    }
+    return true;
+}
+
+void SpectrumColumnMap::mapColumns(const float* values, float* dest) const
+{
+    for (size_t c = 0; c < _columns.size(); ++c)
+    {
+        const auto& column = _columns[c];
+        if (column.endBin > column.firstBin)
+        {
+            dest[c] = juce::FloatVectorOperations::findMaximum(values + column.firstBin, column.endBin - column.firstBin);
+        }
+        else
+        {
+            const auto lower = values[column.firstBin];
+            const auto upper = values[column.firstBin + 1];
+            dest[c] = lower + column.fraction * (upper - lower);
+        }
+    }
+}
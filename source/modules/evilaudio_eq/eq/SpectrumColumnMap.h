@@ -0,0 +1,118 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+
+/**
+ *  Maps the bins of a magnitude spectrum onto the pixel columns of a log-frequency plot.
+ *
+ *  The mapping only depends on the plot width, sample rate and FFT size, so it is worked out
+ *  once and kept until one of those changes; drawing a frame then needs no per-bin logarithms.
+ *  Where several bins fall into one column they are reduced to their minimum and maximum, so
+ *  narrow peaks survive; where a column lies between two bins (at the low end of the plot)
+ *  the spectrum is interpolated. Either way the path has display resolution, not FFT resolution.
+ *
+ *  Not thread safe; each view (or each analyser drawn on the message thread) keeps its own.
+ */
+class SpectrumColumnMap
+{
+public:
+    SpectrumColumnMap() = default;
+
+    /**
+     * Rebuilds the map if any of its inputs changed, otherwise does nothing.
+     *
+     * @param numColumns    Width of the plot in pixels.
+     * @param sampleRate    Sample rate the spectrum was measured at.
+     * @param fftSize       FFT size; the spectrum has fftSize / 2 bins.
+     * @param minFrequency  Frequency at the left edge of the plot.
+     * @param numOctaves    Octaves spanned by the plot.
+     * @return true if the map was rebuilt.
+     */
+    bool update(int numColumns, double sampleRate, int fftSize, float minFrequency, float numOctaves);
+
+    /**
+     * Builds a path through the spectrum, one or two points per pixel column.
+     *
+     * @param magnitudes  fftSize / 2 linear magnitudes, as passed to update().
+     * @param bounds      Plot area; ceilingDecibels is at the top, floorDecibels at the bottom.
+     */
+    void createPath(juce::Path& path, const float* magnitudes, juce::Rectangle<float> bounds,
+                    float floorDecibels = -80.0f, float ceilingDecibels = 0.0f) const
+    {
+        createMappedPath(path, magnitudes, bounds, [&](float magnitude)
+        {
+            return juce::jmap(juce::Decibels::gainToDecibels(magnitude, floorDecibels),
+                              floorDecibels, ceilingDecibels, bounds.getBottom(), bounds.getY());
+        });
+    }
+
+    /**
+     * As createPath(), but with a caller-supplied mapping from value to y coordinate. It is
+     * only called once or twice per column.
+     */
+    template<typename ValueToY>
+    void createMappedPath(juce::Path& path, const float* values, juce::Rectangle<float> bounds, ValueToY&& valueToY) const
+    {
+        path.clear();
+        if (_columns.empty())
+            return;
+
+        path.preallocateSpace(int(_columns.size()) * 6 + 8);
+
+        for (size_t c = 0; c < _columns.size(); ++c)
+        {
+            const auto& column = _columns[c];
+            const auto x = bounds.getX() + float(c) + 0.5f;
+
+            float top, bottom;
+            if (column.endBin > column.firstBin)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax(values + column.firstBin,
+                                                                              column.endBin - column.firstBin);
+                top = valueToY(range.getEnd());
+                bottom = valueToY(range.getStart());
+            }
+            else
+            {
+                const auto lower = values[column.firstBin];
+                const auto upper = values[column.firstBin + 1];
+                top = bottom = valueToY(lower + column.fraction * (upper - lower));
+            }
+
+            if (c == 0)
+                path.startNewSubPath(x, top);
+            else
+                path.lineTo(x, top);
+
+            if (bottom != top)
+                path.lineTo(x, bottom);
+        }
+    }
+
+    /**
+     * Reduces the spectrum to one value per column: the largest bin in the column, or the
+     * interpolated value between bins. Writes getNumColumns() values to dest.
+     */
+    void mapColumns(const float* values, float* dest) const;
+
+    int getNumColumns() const noexcept { return int(_columns.size()); }
+
+private:
+    struct Column
+    {
+        /** Bins [firstBin, endBin) lie in this column. If the range is empty, the value is
+            interpolated between firstBin and firstBin + 1 at the given fraction. */
+        int firstBin = 0;
+        int endBin = 0;
+        float fraction = 0.0f;
+    };
+
+    std::vector<Column> _columns;
+    int _numColumns = 0;
+    double _sampleRate = 0.0;
+    int _fftSize = 0;
+    float _minFrequency = 0.0f;
+    float _numOctaves = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumColumnMap)
+};
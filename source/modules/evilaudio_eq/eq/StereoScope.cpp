@@ -0,0 +1,75 @@
+#include "StereoScope.h"
+
+StereoScope::StereoScope(const juce::CriticalSection& audioLock)
+    : _audioLock(audioLock)
+{
+}
+
+StereoScope::~StereoScope()
+{
+    swapStorage(nullptr);
+}
+
+void StereoScope::addAudioData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels)
+{
+    if (_storage == nullptr || numChannels <= 0)
+        return;
+
+    const auto* left = buffer.getReadPointer(startChannel);
+    const auto* right = buffer.getReadPointer(startChannel + juce::jmin(1, numChannels - 1));
+
+    AnalyserRing::writePair(_storage->left, _storage->right, buffer.getNumSamples(),
+        [left, right](float* __restrict l, float* __restrict r, int offset, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                l[i] = left[offset + i];
+                r[i] = right[offset + i];
+            }
+        });
+}
+
+void StereoScope::addSubscriber()
+{
+    if (++_subscribers == 1)
+    {
+        _readPosition = 0;
+        swapStorage(std::make_unique<Storage>());
+    }
+}
+
+void StereoScope::removeSubscriber()
+{
+    jassert(_subscribers > 0);
+    if (--_subscribers == 0)
+        swapStorage(nullptr);
+}
+
+int StereoScope::readSamples(float* left, float* right, int maxSamples)
+{
+    if (_storage == nullptr || maxSamples <= 0)
+        return 0;
+
+    // The left ring is published first, so only go as far as the right one has got.
+    const auto writePosition = juce::jmin(_storage->left.getWritePosition(), _storage->right.getWritePosition());
+    if (writePosition <= _readPosition)
+        return 0;
+
+    // Only the newest samples matter for a display; anything older is skipped.
+    const auto numSamples = int(juce::jmin(writePosition - _readPosition, juce::uint64(maxSamples),
+                                           juce::uint64(_storage->left.getCapacity() / 2)));
+    const auto position = writePosition - juce::uint64(numSamples);
+
+    // If the audio thread overwrote them while copying, the next call takes the newest ones instead.
+    if (! _storage->left.read(position, left, numSamples) || ! _storage->right.read(position, right, numSamples))
+        return 0;
+
+    _readPosition = writePosition;
+    return numSamples;
+}
+
+void StereoScope::swapStorage(std::unique_ptr<Storage> newStorage)
+{
+    const juce::ScopedLock audioLocked(_audioLock);
+    std::swap(_storage, newStorage);
+}
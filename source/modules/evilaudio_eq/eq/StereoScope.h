@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "AnalyserRing.h"
+
+/**
+ *  Captures the left and right channels of the output for the phase views.
+ *
+ *  Fed from the same audio-thread tap as the output analyser. The two channels go into a
+ *  pair of rings written in one pass, so a position refers to the same sample in both;
+ *  the message thread drains them at display rate. Like the analysers it costs nothing on
+ *  the audio thread until something subscribes.
+ */
+class StereoScope
+{
+public:
+    /**
+     * @param audioLock Lock held by the audio thread while it calls addAudioData(), so
+     *                  the rings can be swapped in and out safely.
+     */
+    explicit StereoScope(const juce::CriticalSection& audioLock);
+    ~StereoScope();
+
+    /** Feeds a block; a mono block is used for both channels. Audio thread only. */
+    void addAudioData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels);
+
+    /** Sets the sample rate the views use for their time constants. Any thread. */
+    void setSampleRate(double newSampleRate) noexcept { _sampleRate = newSampleRate; }
+    double getSampleRate() const noexcept { return _sampleRate; }
+
+    /** The first subscriber allocates the rings, the last one frees them. Message thread only. */
+    void addSubscriber();
+    void removeSubscriber();
+
+    /**
+     * Copies the samples written since the last call, at most maxSamples of them (the
+     * newest ones if more are waiting). Message thread only.
+     *
+     * @return The number of samples copied to left and right.
+     */
+    int readSamples(float* left, float* right, int maxSamples);
+
+    /** Size of each ring; views never need more than this per frame. */
+    static constexpr int ringSize = 1 << 15;
+
+private:
+    struct Storage
+    {
+        Storage() : left(ringSize), right(ringSize) {}
+
+        AnalyserRing left;
+        AnalyserRing right;
+    };
+
+    void swapStorage(std::unique_ptr<Storage> newStorage);
+
+    const juce::CriticalSection& _audioLock;
+    std::unique_ptr<Storage> _storage;
+    std::atomic<double> _sampleRate{ 48000.0 };
+    juce::uint64 _readPosition = 0;
+    int _subscribers = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoScope)
+};
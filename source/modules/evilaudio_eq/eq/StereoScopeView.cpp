@@ -0,0 +1,153 @@
+#include "StereoScopeView.h"
+
+StereoScopeView::StereoScopeView(StereoScope& scope)
+    : _scope(scope),
+      _left(size_t(StereoScope::ringSize / 2)),
+      _right(size_t(StereoScope::ringSize / 2))
+{
+    setOpaque(true);
+    _scope.addSubscriber();
+
+    // Background through green to white, so single samples are faint and dense areas glow.
+    juce::ColourGradient gradient(juce::Colour(0xff101010), 0.0f, 0.0f, juce::Colours::white, 1.0f, 0.0f, false);
+    gradient.addColour(0.4, juce::Colour(0xff1f7a3a));
+    gradient.addColour(0.8, juce::Colour(0xffa8f0a0));
+
+    for (int i = 0; i < numColours; ++i)
+        _colours[size_t(i)] = gradient.getColourAtPosition(double(i) / (numColours - 1)).getPixelARGB();
+}
+
+StereoScopeView::~StereoScopeView()
+{
+    _scope.removeSubscriber();
+}
+
+void StereoScopeView::resized()
+{
+    const auto size = juce::jmax(0, juce::jmin(getScopeArea().getWidth(), getScopeArea().getHeight()));
+    if (size == _size)
+        return;
+
+    _size = size;
+    _accumulator.assign(size_t(size * size), 0.0f);
+    _image = size > 0 ? juce::Image(juce::Image::ARGB, size, size, true) : juce::Image();
+}
+
+juce::Rectangle<int> StereoScopeView::getScopeArea() const
+{
+    return getLocalBounds().withTrimmedBottom(14);
+}
+
+juce::Rectangle<int> StereoScopeView::getMeterArea() const
+{
+    return getLocalBounds().removeFromBottom(10);
+}
+
+void StereoScopeView::update()
+{
+    const auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    const auto elapsed = _lastUpdateTime > 0.0 ? juce::jlimit(0.0, 1.0, now - _lastUpdateTime) : 0.0;
+    _lastUpdateTime = now;
+
+    // Fade everything that was drawn before, in one pass.
+    if (! _accumulator.empty())
+        juce::FloatVectorOperations::multiply(_accumulator.data(), float(std::exp(-elapsed / decaySeconds)), int(_accumulator.size()));
+
+    const auto numSamples = _scope.readSamples(_left.data(), _right.data(), int(_left.size()));
+    const auto sampleRate = juce::jmax(1.0, _scope.getSampleRate());
+
+    // Exponentially weighted sums over the last correlationSeconds or so.
+    const auto keep = std::exp(-numSamples / (correlationSeconds * sampleRate));
+    double lr = 0.0, ll = 0.0, rr = 0.0;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        lr += double(_left[size_t(i)]) * _right[size_t(i)];
+        ll += double(_left[size_t(i)]) * _left[size_t(i)];
+        rr += double(_right[size_t(i)]) * _right[size_t(i)];
+    }
+    _sumLR = keep * _sumLR + (1.0 - keep) * lr;
+    _sumLL = keep * _sumLL + (1.0 - keep) * ll;
+    _sumRR = keep * _sumRR + (1.0 - keep) * rr;
+
+    const auto power = std::sqrt(_sumLL * _sumRR);
+    _correlation = power > 1.0e-12 ? float(juce::jlimit(-1.0, 1.0, _sumLR / power)) : 0.0f;
+
+    accumulate(_left.data(), _right.data(), numSamples);
+    renderImage();
+    repaint();
+}
+
+void StereoScopeView::accumulate(const float* left, const float* right, int numSamples)
+{
+    if (_size <= 0)
+        return;
+
+    // Full scale on either channel reaches the edge of the square.
+    const auto half = 0.5f * float(_size - 1);
+    const auto scale = half * juce::MathConstants<float>::sqrt2 * 0.5f;
+
+    // Every sample adds the same amount, so the brightness follows the density of the trace.
+    constexpr auto increment = 0.05f;
+
+    // Left-only signals go up the top-left diagonal, under the "L" label.
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto side = (right[i] - left[i]) * scale;
+        const auto mid = (left[i] + right[i]) * scale;
+        const auto x = int(half + juce::jlimit(-half, half, side));
+        const auto y = int(half - juce::jlimit(-half, half, mid));
+        _accumulator[size_t(y * _size + x)] += increment;
+    }
+}
+
+void StereoScopeView::renderImage()
+{
+    if (! _image.isValid())
+        return;
+
+    const juce::Image::BitmapData pixels(_image, juce::Image::BitmapData::writeOnly);
+    jassert(pixels.pixelFormat == juce::Image::ARGB);
+
+    for (int y = 0; y < _size; ++y)
+    {
+        const auto* row = _accumulator.data() + size_t(y * _size);
+        auto* dest = reinterpret_cast<juce::PixelARGB*>(pixels.getLinePointer(y));
+
+        for (int x = 0; x < _size; ++x)
+            dest[x] = _colours[size_t(juce::jmin(numColours - 1, int(row[x] * (numColours - 1))))];
+    }
+}
+
+void StereoScopeView::paint(juce::Graphics& g)
+{
+    EVILAUDIO_PROFILE_PAINT(*this);
+    g.fillAll(juce::Colour(0xff101010));
+
+    const auto scopeArea = getScopeArea();
+    const auto square = scopeArea.withSizeKeepingCentre(_size, _size);
+    if (_image.isValid())
+        g.drawImageAt(_image, square.getX(), square.getY());
+
+    // The L and R axes on the diagonals, and the mid axis.
+    g.setColour(juce::Colours::silver.withAlpha(0.3f));
+    const auto bounds = square.toFloat();
+    g.drawLine({ bounds.getTopLeft(), bounds.getBottomRight() }, 1.0f);
+    g.drawLine({ bounds.getTopRight(), bounds.getBottomLeft() }, 1.0f);
+    g.drawVerticalLine(square.getCentreX(), bounds.getY(), bounds.getBottom());
+
+    g.setFont(10.0f);
+    g.setColour(juce::Colours::silver);
+    g.drawText("L", square.withSize(12, 12), juce::Justification::centred);
+    g.drawText("R", square.withLeft(square.getRight() - 12).withHeight(12), juce::Justification::centred);
+
+    // Correlation meter: -1 on the left, +1 on the right, red where the channels cancel.
+    const auto meter = getMeterArea().toFloat();
+    g.setColour(juce::Colours::silver.withAlpha(0.3f));
+    g.drawRect(meter, 1.0f);
+    g.drawVerticalLine(juce::roundToInt(meter.getCentreX()), meter.getY(), meter.getBottom());
+
+    const auto x = juce::jmap(_correlation, -1.0f, 1.0f, meter.getX(), meter.getRight());
+    g.setColour(_correlation < 0.0f ? juce::Colours::indianred : juce::Colours::greenyellow);
+    g.fillRect(juce::Rectangle<float>(juce::jmin(x, meter.getCentreX()), meter.getY() + 1.0f,
+                                      std::abs(x - meter.getCentreX()), meter.getHeight() - 2.0f));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <evilaudio_lookandfeel/evilaudio_lookandfeel.h>
+#include "StereoScope.h"
+
+/**
+ *  Goniometer and correlation meter for the output of the equaliser.
+ *
+ *  The goniometer plots every sample as a point (side across, mid up) into a float
+ *  accumulation buffer that decays by a constant factor each frame, so a second of audio
+ *  costs one increment per sample plus one vectorised multiply per frame, whatever the
+ *  sample rate. The buffer is turned into an image through a colour table once per frame.
+ *  Below it, the correlation meter shows the normalised cross-correlation of the two
+ *  channels, from -1 (out of phase) through 0 (unrelated) to +1 (mono).
+ *
+ *  Subscribes to the StereoScope for as long as it exists. Message thread only.
+ */
+class StereoScopeView : public juce::Component
+{
+public:
+    explicit StereoScopeView(StereoScope& scope);
+    ~StereoScopeView() override;
+
+    /** Drains the new samples into the display and repaints. Call once per display frame. */
+    void update();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    /** Returns the smoothed correlation, from -1 to 1. */
+    float getCorrelation() const noexcept { return _correlation; }
+
+private:
+    void accumulate(const float* left, const float* right, int numSamples);
+    void renderImage();
+    juce::Rectangle<int> getScopeArea() const;
+    juce::Rectangle<int> getMeterArea() const;
+
+    static constexpr int numColours = 256;
+    /** Time for a point in the goniometer and the correlation sums to fall to 1/e. */
+    static constexpr double decaySeconds = 0.15;
+    static constexpr double correlationSeconds = 0.3;
+
+    StereoScope& _scope;
+
+    std::vector<float> _left, _right;
+    std::vector<float> _accumulator;
+    int _size = 0;
+    juce::Image _image;
+    std::array<juce::PixelARGB, numColours> _colours;
+
+    double _sumLR = 0.0, _sumLL = 0.0, _sumRR = 0.0;
+    float _correlation = 0.0f;
+    double _lastUpdateTime = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StereoScopeView)
+};
@@ -0,0 +1,189 @@
+#include "TransferFunctionAnalyser.h"
+
+/** FFT, window and averaged spectra for one set of settings. Worker thread only. */
+struct TransferFunctionAnalyser::Pipeline
+{
+    Pipeline(const AnalyserSettings& settingsToUse, double sampleRate, EqualiserTables& tables)
+        : settings(settingsToUse),
+          fftSize(settings.getFftSize()),
+          hopSize(settings.getHopSize(sampleRate)),
+          fft(FftBackend::create(juce::jlimit(AnalyserSettings::minFftOrder, AnalyserSettings::maxFftOrder, settings.fftOrder))),
+          window(tables.getWindowTable(size_t(fftSize), settings.window)),
+          input(size_t(fftSize)),
+          output(size_t(fftSize)),
+          inputSpectrum(size_t(fftSize / 2 + 1)),
+          outputSpectrum(size_t(fftSize / 2 + 1)),
+          sxx(size_t(fftSize / 2), 0.0f),
+          syy(size_t(fftSize / 2), 0.0f),
+          sxyRe(size_t(fftSize / 2), 0.0f),
+          sxyIm(size_t(fftSize / 2), 0.0f)
+    {
+        const auto hopSeconds = sampleRate > 0.0 ? hopSize / sampleRate : 0.0;
+        smoothing = juce::jmin(1.0f / minAveragedFrames,
+                               float(1.0 - std::exp(-hopSeconds / juce::jmax(0.001f, settings.averagingTimeSeconds))));
+    }
+
+    /** Transforms the windowed frames in input and output and folds them into the averages. */
+    void process(TransferFunctionFrame& frame)
+    {
+        const auto numBins = int(sxx.size());
+
+        juce::FloatVectorOperations::multiply(input.data(), window.data(), fftSize);
+        juce::FloatVectorOperations::multiply(output.data(), window.data(), fftSize);
+        fft->performRealForward(input.data(), inputSpectrum.data());
+        fft->performRealForward(output.data(), outputSpectrum.data());
+
+        const auto keep = isWarmingUp ? 0.0f : 1.0f - smoothing;
+        const auto take = isWarmingUp ? 1.0f : smoothing;
+        isWarmingUp = false;
+
+        frame.magnitudes.resize(size_t(numBins));
+        frame.coherence.resize(size_t(numBins));
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            const auto x = inputSpectrum[size_t(k)];
+            const auto y = outputSpectrum[size_t(k)];
+
+            // conj(X) Y
+            const auto crossRe = x.real() * y.real() + x.imag() * y.imag();
+            const auto crossIm = x.real() * y.imag() - x.imag() * y.real();
+
+            auto& xx = sxx[size_t(k)];
+            auto& yy = syy[size_t(k)];
+            auto& xyRe = sxyRe[size_t(k)];
+            auto& xyIm = sxyIm[size_t(k)];
+
+            xx = keep * xx + take * std::norm(x);
+            yy = keep * yy + take * std::norm(y);
+            xyRe = keep * xyRe + take * crossRe;
+            xyIm = keep * xyIm + take * crossIm;
+
+            const auto crossPower = xyRe * xyRe + xyIm * xyIm;
+            const auto inputPower = juce::jmax(xx, std::numeric_limits<float>::min());
+
+            frame.magnitudes[size_t(k)] = std::sqrt(crossPower) / inputPower;
+            frame.coherence[size_t(k)] = juce::jlimit(0.0f, 1.0f, crossPower / (inputPower * juce::jmax(yy, std::numeric_limits<float>::min())));
+        }
+    }
+
+    const AnalyserSettings settings;
+    const int fftSize;
+    const int hopSize;
+    std::unique_ptr<FftBackend> fft;
+    const std::vector<float>& window;
+    std::vector<float> input, output;
+    std::vector<std::complex<float>> inputSpectrum, outputSpectrum;
+    std::vector<float> sxx, syy, sxyRe, sxyIm;
+    float smoothing = 1.0f;
+    bool isWarmingUp = true;
+};
+
+/** The rings and the worker's pipeline, allocated while there are subscribers. */
+struct TransferFunctionAnalyser::Storage : public AnalyserStorage
+{
+    Storage(int audioFifoSize, double sampleRateToUse, const AnalyserSettings& settings, EqualiserTables& tables)
+        : AnalyserStorage(audioFifoSize, sampleRateToUse),
+          pipeline(std::make_unique<Pipeline>(settings, sampleRateToUse, tables))
+    {
+        frameSize = pipeline->fftSize;
+    }
+
+    void rebuildPipeline(const AnalyserSettings& settings, EqualiserTables& tables) override
+    {
+        pipeline = std::make_unique<Pipeline>(settings, sampleRate, tables);
+        frameSize.store(pipeline->fftSize, std::memory_order_relaxed);
+    }
+
+    int getHopSize() const override
+    {
+        return pipeline->hopSize;
+    }
+
+    bool readFrame(juce::uint64 position) override
+    {
+        return inputRing.read(position, pipeline->input.data(), pipeline->fftSize)
+            && outputRing.read(position, pipeline->output.data(), pipeline->fftSize);
+    }
+
+    juce::uint64 getFrameGeneration() const noexcept override
+    {
+        return frames.getGeneration();
+    }
+
+    AnalyserRing& inputRing = ring;
+    AnalyserRing& outputRing = secondRing;
+    std::unique_ptr<Pipeline> pipeline;
+    TripleBuffer<TransferFunctionFrame> frames;
+};
+
+//==============================================================================
+
+TransferFunctionAnalyser::TransferFunctionAnalyser(const juce::CriticalSection& audioLock)
+    : AnalyserBase(audioLock)
+{
+}
+
+TransferFunctionAnalyser::~TransferFunctionAnalyser()
+{
+    stopAnalysis();
+}
+
+void TransferFunctionAnalyser::addInputData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels)
+{
+    if (auto* storage = getStorage())
+        storage->inputRing.write(buffer, startChannel, numChannels);
+}
+
+void TransferFunctionAnalyser::addOutputData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels)
+{
+    auto* storage = getStorage();
+    if (storage == nullptr)
+        return;
+
+    storage->outputRing.write(buffer, startChannel, numChannels);
+    notifyIfReady();
+}
+
+void TransferFunctionAnalyser::processFrame()
+{
+    auto& storage = *getStorage();
+    auto& frame = storage.frames.getWriteBuffer();
+    storage.pipeline->process(frame);
+    frame.sampleRate = storage.sampleRate;
+    frame.fftSize = storage.pipeline->fftSize;
+    storage.frames.publish();
+}
+
+void TransferFunctionAnalyser::createPaths(juce::Path& response, juce::Path& coherence,
+                                           juce::Rectangle<float> bounds, float minFreq, float maxDecibels)
+{
+    response.clear();
+    coherence.clear();
+    auto* storage = getStorage();
+    if (storage == nullptr)
+        return;
+
+    storage->frames.acquire();
+    const auto& frame = storage->frames.getReadBuffer();
+    if (frame.magnitudes.empty())
+        return;
+
+    columnMap.update(juce::roundToInt(bounds.getWidth()), frame.sampleRate, frame.fftSize, minFreq, 10.0f);
+    columnMap.createPath(response, frame.magnitudes.data(), bounds, -maxDecibels, maxDecibels);
+    columnMap.createMappedPath(coherence, frame.coherence.data(), bounds, [&](float value)
+    {
+        return juce::jmap(value, bounds.getBottom(), bounds.getY());
+    });
+}
+
+TransferFunctionAnalyser::Storage* TransferFunctionAnalyser::getStorage() const noexcept
+{
+    return static_cast<Storage*>(AnalyserBase::getStorage());
+}
+
+std::unique_ptr<AnalyserStorage> TransferFunctionAnalyser::createStorage(int audioFifoSize, double sampleRate,
+                                                                         const AnalyserSettings& settings, EqualiserTables& tables)
+{
+    return std::make_unique<Storage>(audioFifoSize, sampleRate, settings, tables);
+}
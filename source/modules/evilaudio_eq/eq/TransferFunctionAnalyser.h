@@ -0,0 +1,75 @@
+#pragma once
+
+#include "juce_dsp/juce_dsp.h"
+#include "AnalyserBase.h"
+#include "FftBackend.h"
+#include "SpectrumColumnMap.h"
+#include "TripleBuffer.h"
+
+/** A measured transfer function handed from the analysis worker to the editor. */
+struct TransferFunctionFrame
+{
+    /** |H| = |Sxy| / Sxx per bin. */
+    std::vector<float> magnitudes;
+    /** |Sxy|^2 / (Sxx Syy) per bin, from 0 (unrelated) to 1 (fully explained by a linear system). */
+    std::vector<float> coherence;
+    double sampleRate = 0.0;
+    int fftSize = 0;
+};
+
+/**
+ *  Measures the equaliser's actual response from the audio passing through it.
+ *
+ *  Input and output are captured in the same audio callback into a pair of rings that are
+ *  allocated together, so a given absolute position refers to the same moment in both. The
+ *  worker transforms time-aligned input and output frames with the same window and FFT and
+ *  averages the auto- and cross-spectra, from which it derives the transfer function
+ *  H = Sxy / Sxx and the coherence |Sxy|^2 / (Sxx Syy). Where the coherence is low the
+ *  measured response can't be trusted, e.g. where the programme material has no energy.
+ *
+ *  Like Analyser, it costs nothing until subscribed to and runs on the shared AnalysisScheduler.
+ *  The input goes into the storage's first ring and the output into its second.
+ */
+class TransferFunctionAnalyser : public AnalyserBase
+{
+public:
+    /**
+     * @param audioLock Lock held by the audio thread while it calls addInputData() and
+     *                  addOutputData(), so the storage can be swapped in and out safely.
+     */
+    explicit TransferFunctionAnalyser(const juce::CriticalSection& audioLock);
+    ~TransferFunctionAnalyser() override;
+
+    /** Feeds the unprocessed block. Audio thread only; call before addOutputData(). */
+    void addInputData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels);
+    /** Feeds the processed block of the same callback. Audio thread only. */
+    void addOutputData(const juce::AudioBuffer<float>& buffer, int startChannel, int numChannels);
+
+    /**
+     * Builds paths through the latest measurement. Message thread only.
+     *
+     * The FFT size, overlap and window come from the analysers' settings. The cross-spectra
+     * are always averaged exponentially (coherence needs several frames to mean anything)
+     * with the settings' time constant, but over at least minAveragedFrames frames.
+     *
+     * @param response    Receives |H|, with +maxDecibels at the top of bounds and -maxDecibels at the bottom.
+     * @param coherence   Receives the coherence, 1 at the top of bounds and 0 at the bottom.
+     */
+    void createPaths(juce::Path& response, juce::Path& coherence, juce::Rectangle<float> bounds,
+                     float minFreq, float maxDecibels);
+
+    static constexpr int minAveragedFrames = 8;
+
+private:
+    struct Pipeline;
+    struct Storage;
+
+    Storage* getStorage() const noexcept;
+    std::unique_ptr<AnalyserStorage> createStorage(int audioFifoSize, double sampleRate,
+                                                   const AnalyserSettings& settings, EqualiserTables& tables) override;
+    void processFrame() override;
+
+    SpectrumColumnMap columnMap;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TransferFunctionAnalyser)
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ *  Lock-free single-producer, single-consumer handoff of whole frames.
+ *
+ *  The writer fills its private back buffer and publish()es it; the reader acquire()s
+ *  the most recently published buffer whenever it is ready to draw. Three buffers mean
+ *  that the writer always has one to fill and the reader always has one to read, so
+ *  neither side ever waits for the other. Frames published while the reader was busy
+ *  are simply superseded by newer ones.
+ *
+ *  Each published frame bumps a generation counter, which readers can compare against
+ *  the last generation they drew to find out whether anything has changed.
+ */
+template<typename FrameType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    /** Returns the buffer the writer may fill. Writer thread only. */
+    FrameType& getWriteBuffer() noexcept
+    {
+        return _buffers[size_t(_writeIndex)];
+    }
+
+    /** Hands the write buffer over to the reader and takes a spare one back. Writer thread only. */
+    void publish() noexcept
+    {
+        const auto previous = _middle.exchange(_writeIndex | freshFlag, std::memory_order_acq_rel);
+        _writeIndex = previous & indexMask;
+        _generation.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * Swaps in the most recently published frame, if there is one that hasn't been
+     * acquired yet. Reader thread only.
+     *
+     * @return true if getReadBuffer() now refers to a newer frame.
+     */
+    bool acquire() noexcept
+    {
+        if ((_middle.load(std::memory_order_acquire) & freshFlag) == 0)
+            return false;
+
+        const auto previous = _middle.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & indexMask;
+        return true;
+    }
+
+    /** Returns the frame last acquired by the reader. Reader thread only. */
+    const FrameType& getReadBuffer() const noexcept
+    {
+        return _buffers[size_t(_readIndex)];
+    }
+
+    /** Returns the number of frames published so far. Safe to call from any thread. */
+    juce::uint64 getGeneration() const noexcept
+    {
+        return _generation.load(std::memory_order_acquire);
+    }
+
+    /** Applies a function to every buffer, e.g. to size them. Only call while neither side is active. */
+    template<typename Function>
+    void forEachBuffer(Function&& function)
+    {
+        for (auto& buffer : _buffers)
+            function(buffer);
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+
+    std::array<FrameType, 3> _buffers;
+    int _writeIndex = 0;
+    std::atomic<int> _middle{ 1 };
+    int _readIndex = 2;
+    std::atomic<juce::uint64> _generation{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(TripleBuffer)
+};
@@ -10,5 +10,16 @@
 
 #include "evilaudio_eq.h"
 
+#include "eq/AnalysisScheduler.cpp"
+#include "eq/AnalyserBase.cpp"
+#include "eq/EqualiserTables.cpp"
+#include "eq/FftBackend.cpp"
+#include "eq/FrequencyResponseCurve.cpp"
+#include "eq/PlotRenderer.cpp"
+#include "eq/Spectrogram.cpp"
+#include "eq/SpectrumColumnMap.cpp"
+#include "eq/StereoScope.cpp"
+#include "eq/StereoScopeView.cpp"
+#include "eq/TransferFunctionAnalyser.cpp"
 #include "eq/ParametricEqualiserEditor.cpp"   
 #include "eq/ParametricEqualiserProcessor.cpp"
\ No newline at end of file
@@ -13,7 +13,7 @@
   name:               Evil Audio Equaliser
   minimumCppStandard: 17
 
-  dependencies:       juce_gui_basics
+  dependencies:       juce_gui_basics evilaudio_lookandfeel
   OSXFrameworks:      Accelerate
   iOSFrameworks:      Accelerate
 
@@ -25,5 +25,16 @@
 
 #define EVILAUDIO_EQ_H_INCLUDED
 
+#include "eq/AnalysisScheduler.h"
+#include "eq/AnalyserBase.h"
+#include "eq/EqualiserTables.h"
+#include "eq/FftBackend.h"
+#include "eq/FrequencyResponseCurve.h"
+#include "eq/PlotRenderer.h"
+#include "eq/Spectrogram.h"
+#include "eq/SpectrumColumnMap.h"
+#include "eq/StereoScope.h"
+#include "eq/StereoScopeView.h"
+#include "eq/TransferFunctionAnalyser.h"
 #include "eq/ParametricEqualiserEditor.h"
 #include "eq/ParametricEqualiserProcessor.h"
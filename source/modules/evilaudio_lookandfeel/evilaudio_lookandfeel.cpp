@@ -10,4 +10,5 @@
 
 #include "evilaudio_lookandfeel.h"
 
-#include "lookandfeel/evil_audio_LookAndFeel.cpp"
\ No newline at end of file
+#include "lookandfeel/evil_audio_LookAndFeel.cpp"
+#include "lookandfeel/evil_audio_PaintProfiler.cpp"
\ No newline at end of file
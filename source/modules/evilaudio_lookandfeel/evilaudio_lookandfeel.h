@@ -25,4 +25,14 @@
 #pragma once
 #define EVIL_AUDIO_LOOKANDFEEL_H_INCLUDED
 
-#include "lookandfeel/evil_audio_LookAndFeel.h"
\ No newline at end of file
+//==============================================================================
+/** Config: EVILAUDIO_PAINT_PROFILING
+    Times the paint() and resized() of components instrumented with EVILAUDIO_PROFILE_PAINT
+    and EVILAUDIO_PROFILE_LAYOUT, and shows the profiler overlay in the applications.
+*/
+#ifndef EVILAUDIO_PAINT_PROFILING
+ #define EVILAUDIO_PAINT_PROFILING 0
+#endif
+
+#include "lookandfeel/evil_audio_LookAndFeel.h"
+#include "lookandfeel/evil_audio_PaintProfiler.h"
\ No newline at end of file
@@ -8,9 +8,119 @@ EvilAudio_LookAndFeel::EvilAudio_LookAndFeel()
     initialiseColours();
 }
 
+bool EvilAudio_LookAndFeel::SpriteKey::operator==(const SpriteKey& other) const noexcept
+{
+    return width == other.width && height == other.height && scale == other.scale && style == other.style
+        && position == other.position && extra == other.extra && colours == other.colours;
+}
+
+size_t EvilAudio_LookAndFeel::SpriteKeyHash::operator()(const SpriteKey& key) const noexcept
+{
+    size_t hash = 0;
+    for (auto value : { key.width, key.height, key.scale, key.style, key.position, key.extra, int(key.colours) })
+        hash = hash * 31u + std::hash<int>()(value);
+
+    return hash;
+}
+
+juce::uint32 EvilAudio_LookAndFeel::hashSliderColours(juce::Slider& slider)
+{
+    // The slider may override any of these, so they are part of the key rather than a
+    // reason to flush the cache.
+    juce::uint32 hash = slider.isEnabled() ? 1u : 0u;
+    for (auto id : { juce::Slider::rotarySliderFillColourId, juce::Slider::rotarySliderOutlineColourId,
+                     juce::Slider::thumbColourId, juce::Slider::trackColourId, juce::Slider::backgroundColourId })
+        hash = hash * 16777619u ^ slider.findColour(id).getARGB();
+
+    return hash;
+}
+
+void EvilAudio_LookAndFeel::clearSpriteCache()
+{
+    _sprites.clear();
+}
+
+const juce::Image& EvilAudio_LookAndFeel::getSprite(const SpriteKey& key, float scale, const std::function<void(juce::Graphics&)>& render)
+{
+    if (auto found = _sprites.find(key); found != _sprites.end())
+        return found->second;
+
+    // Sliders are rarely resized or restyled, so a full cache is simply started again.
+    if (_sprites.size() >= maxSprites)
+        _sprites.clear();
+
+    juce::Image sprite(juce::Image::ARGB, juce::roundToInt(key.width * scale), juce::roundToInt(key.height * scale), true);
+    {
+        juce::Graphics g(sprite);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        render(g);
+    }
+
+    return _sprites.emplace(key, std::move(sprite)).first->second;
+}
+
+void EvilAudio_LookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                                             float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
+                                             juce::Slider& slider)
+{
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (width <= 0 || height <= 0 || scale <= 0.0f)
+        return;
+
+    const auto step = juce::roundToInt(juce::jlimit(0.0f, 1.0f, sliderPosProportional) * (rotarySteps - 1));
+    const auto position = float(step) / (rotarySteps - 1);
+
+    SpriteKey key;
+    key.width = width;
+    key.height = height;
+    key.scale = juce::roundToInt(scale * 100.0f);
+    key.style = int(slider.getSliderStyle());
+    key.position = step;
+    key.extra = juce::roundToInt(rotaryStartAngle * 1000.0f) * 31 + juce::roundToInt(rotaryEndAngle * 1000.0f);
+    key.colours = hashSliderColours(slider);
+
+    const auto& sprite = getSprite(key, scale, [&](juce::Graphics& spriteGraphics)
+    {
+        juce::LookAndFeel_V4::drawRotarySlider(spriteGraphics, 0, 0, width, height, position,
+                                               rotaryStartAngle, rotaryEndAngle, slider);
+    });
+
+    g.setOpacity(1.0f);
+    g.drawImage(sprite, juce::Rectangle<int>(x, y, width, height).toFloat());
+}
+
 void EvilAudio_LookAndFeel::drawLinearSlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, juce::Slider::SliderStyle style, juce::Slider& slider)
 {
-    juce::LookAndFeel_V4::drawLinearSlider(g, x, y, width, height, sliderPos, minSliderPos, maxSliderPos, style, slider);
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    // Two and three value sliders have too many combinations to be worth caching.
+    if (slider.isTwoValue() || slider.isThreeValue() || width <= 0 || height <= 0 || scale <= 0.0f)
+    {
+        juce::LookAndFeel_V4::drawLinearSlider(g, x, y, width, height, sliderPos, minSliderPos, maxSliderPos, style, slider);
+        return;
+    }
+
+    // The thumb is placed to the nearest physical pixel, which is as fine as it can be drawn.
+    const auto origin = float(slider.isHorizontal() ? x : y);
+    const auto pixel = juce::roundToInt((sliderPos - origin) * scale);
+    const auto position = float(pixel) / scale;
+
+    SpriteKey key;
+    key.width = width;
+    key.height = height;
+    key.scale = juce::roundToInt(scale * 100.0f);
+    key.style = int(style);
+    key.position = pixel;
+    key.colours = hashSliderColours(slider);
+
+    const auto& sprite = getSprite(key, scale, [&](juce::Graphics& spriteGraphics)
+    {
+        juce::LookAndFeel_V4::drawLinearSlider(spriteGraphics, 0, 0, width, height, position,
+                                               minSliderPos - origin, maxSliderPos - origin, style, slider);
+    });
+
+    g.setOpacity(1.0f);
+    g.drawImage(sprite, juce::Rectangle<int>(x, y, width, height).toFloat());
 }
 
 
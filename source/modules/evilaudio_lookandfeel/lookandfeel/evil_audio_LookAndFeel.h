@@ -2,20 +2,64 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 
+/**
+ *  The Evil Audio look-and-feel.
+ *
+ *  Rotary and single-value linear sliders are drawn once into a sprite per size, display
+ *  scale, colour set and quantised position, and blitted from then on. A view full of
+ *  knobs repaints by copying images instead of stroking and filling paths for every one
+ *  of them. Sprites are only used on the message thread, like the rest of the class.
+ */
 class EvilAudio_LookAndFeel : public juce::LookAndFeel_V4
 {
 public:
     EvilAudio_LookAndFeel();
-     
 
+    void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+        float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
+        juce::Slider& slider) override;
 
     void drawLinearSlider(juce::Graphics& g, int x, int y, int width, int height,
         float sliderPos, float minSliderPos, float maxSliderPos,
         juce::Slider::SliderStyle style, juce::Slider& slider) override;
 
+    /** Drops every cached sprite, e.g. after changing colours that sliders don't override. */
+    void clearSpriteCache();
+
+    /** Number of positions a rotary slider's travel is quantised to. */
+    static constexpr int rotarySteps = 256;
+    /** Sprites kept before the cache is emptied and starts again. */
+    static constexpr size_t maxSprites = 512;
+
 private:
+    struct SpriteKey
+    {
+        int width = 0, height = 0;
+        int scale = 0;      // Physical pixel scale, in 1/100ths.
+        int style = 0;
+        int position = 0;   // Quantised position, or thumb position in physical pixels.
+        int extra = 0;      // Hash of the angles or track end positions.
+        juce::uint32 colours = 0;
+
+        bool operator==(const SpriteKey& other) const noexcept;
+    };
+
+    struct SpriteKeyHash
+    {
+        size_t operator()(const SpriteKey& key) const noexcept;
+    };
+
+    /**
+     * Returns the sprite for key, calling render with a Graphics scaled to the physical
+     * pixels of a width x height area to create it if it isn't cached yet.
+     */
+    const juce::Image& getSprite(const SpriteKey& key, float scale, const std::function<void(juce::Graphics&)>& render);
+    static juce::uint32 hashSliderColours(juce::Slider& slider);
 
     void initialiseColours();
     //ColourScheme currentColourScheme;
-   
-};
\ No newline at end of file
+
+    std::unordered_map<SpriteKey, juce::Image, SpriteKeyHash> _sprites;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EvilAudio_LookAndFeel)
+};
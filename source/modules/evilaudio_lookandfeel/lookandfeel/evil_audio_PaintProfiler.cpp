@@ -0,0 +1,209 @@
+#include "evil_audio_PaintProfiler.h"
+
+JUCE_IMPLEMENT_SINGLETON(EvilAudio_PaintProfiler)
+
+EvilAudio_PaintProfiler::ScopedTimer::ScopedTimer(const juce::Component& component, Kind kind) noexcept
+    : _component(component), _kind(kind), _start(juce::Time::getHighResolutionTicks())
+{
+}
+
+EvilAudio_PaintProfiler::ScopedTimer::~ScopedTimer()
+{
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - _start);
+    EvilAudio_PaintProfiler::getInstance()->record(_component, _kind, seconds);
+}
+
+EvilAudio_PaintProfiler::~EvilAudio_PaintProfiler()
+{
+    clearSingletonInstance();
+}
+
+juce::String EvilAudio_PaintProfiler::getComponentName(const juce::Component& component)
+{
+    if (component.getName().isNotEmpty())
+        return component.getName();
+
+    // The class name, without the length prefix GCC and Clang mangle it with or MSVC's "class ".
+    auto name = juce::String(typeid(component).name()).fromLastOccurrenceOf("class ", false, false);
+    return name.trimCharactersAtStart("0123456789");
+}
+
+void EvilAudio_PaintProfiler::record(const juce::Component& component, Kind kind, double seconds)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    auto& entry = _entries[&component];
+    if (entry.type != &typeid(component))
+    {
+        entry = {};
+        entry.type = &typeid(component);
+        entry.name = getComponentName(component);
+    }
+
+    if (kind == Kind::layout)
+    {
+        ++entry.layouts;
+        entry.layoutSeconds += seconds;
+        return;
+    }
+
+    ++entry.paints;
+    entry.paintSeconds += seconds;
+    entry.maxPaintSeconds = juce::jmax(entry.maxPaintSeconds, seconds);
+
+    // The rates are taken over whole seconds so they don't jitter with every paint.
+    const auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    if (entry.windowStart == 0.0)
+        entry.windowStart = now;
+
+    ++entry.windowPaints;
+    entry.windowSeconds += seconds;
+
+    if (const auto elapsed = now - entry.windowStart; elapsed >= 1.0)
+    {
+        entry.paintsPerSecond = entry.windowPaints / elapsed;
+        entry.paintLoad = entry.windowSeconds / elapsed;
+        entry.windowStart = now;
+        entry.windowPaints = 0;
+        entry.windowSeconds = 0.0;
+    }
+}
+
+std::vector<EvilAudio_PaintProfiler::Entry> EvilAudio_PaintProfiler::getEntries() const
+{
+    std::vector<Entry> entries;
+    entries.reserve(_entries.size());
+    for (const auto& [component, entry] : _entries)
+        entries.push_back(entry);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return a.paintLoad != b.paintLoad ? a.paintLoad > b.paintLoad : a.paintSeconds > b.paintSeconds;
+    });
+
+    return entries;
+}
+
+juce::String EvilAudio_PaintProfiler::createReport() const
+{
+    juce::String report;
+    report << juce::String("component").paddedRight(' ', 32)
+           << juce::String("paints").paddedLeft(' ', 8)
+           << juce::String("per s").paddedLeft(' ', 8)
+           << juce::String("avg ms").paddedLeft(' ', 9)
+           << juce::String("max ms").paddedLeft(' ', 9)
+           << juce::String("load %").paddedLeft(' ', 9)
+           << juce::String("layouts").paddedLeft(' ', 9)
+           << juce::String("avg ms").paddedLeft(' ', 9) << juce::newLine;
+
+    for (const auto& entry : getEntries())
+    {
+        report << entry.name.substring(0, 31).paddedRight(' ', 32)
+               << juce::String(entry.paints).paddedLeft(' ', 8)
+               << juce::String(entry.paintsPerSecond, 1).paddedLeft(' ', 8)
+               << juce::String(entry.paints > 0 ? entry.paintSeconds * 1000.0 / entry.paints : 0.0, 3).paddedLeft(' ', 9)
+               << juce::String(entry.maxPaintSeconds * 1000.0, 3).paddedLeft(' ', 9)
+               << juce::String(entry.paintLoad * 100.0, 2).paddedLeft(' ', 9)
+               << juce::String(entry.layouts).paddedLeft(' ', 9)
+               << juce::String(entry.layouts > 0 ? entry.layoutSeconds * 1000.0 / entry.layouts : 0.0, 3).paddedLeft(' ', 9)
+               << juce::newLine;
+    }
+
+    return report;
+}
+
+void EvilAudio_PaintProfiler::dumpToLog() const
+{
+    juce::Logger::writeToLog("Paint profile:" + juce::String(juce::newLine) + createReport());
+}
+
+void EvilAudio_PaintProfiler::reset()
+{
+    _entries.clear();
+}
+
+//==============================================================================
+EvilAudio_PaintProfilerOverlay::EvilAudio_PaintProfilerOverlay()
+{
+    setInterceptsMouseClicks(false, false);
+    setAlwaysOnTop(true);
+    // A translucent overlay would make every refresh repaint the components under it,
+    // and the profiler would count those repaints as theirs.
+    setOpaque(true);
+    setSize(440, rowHeight * (maxRows + 1) + 8);
+    startTimerHz(2);
+}
+
+EvilAudio_PaintProfilerOverlay::~EvilAudio_PaintProfilerOverlay()
+{
+    // At shutdown the profiler may already be gone; don't bring it back just for this.
+    if (_isOutermost)
+        if (auto* profiler = EvilAudio_PaintProfiler::getInstanceWithoutCreating())
+            profiler->dumpToLog();
+}
+
+void EvilAudio_PaintProfilerOverlay::parentHierarchyChanged()
+{
+    updateOutermost();
+}
+
+void EvilAudio_PaintProfilerOverlay::updateOutermost()
+{
+    auto outermost = true;
+    for (auto* ancestor = getParentComponent() != nullptr ? getParentComponent()->getParentComponent() : nullptr;
+         ancestor != nullptr && outermost;
+         ancestor = ancestor->getParentComponent())
+    {
+        for (auto* child : ancestor->getChildren())
+            if (child != this && dynamic_cast<EvilAudio_PaintProfilerOverlay*>(child) != nullptr)
+                outermost = false;
+    }
+
+    _isOutermost = outermost;
+    setVisible(outermost);
+}
+
+void EvilAudio_PaintProfilerOverlay::timerCallback()
+{
+    // The window's overlay may have been added after this one.
+    updateOutermost();
+    if (! _isOutermost)
+        return;
+
+    _entries = EvilAudio_PaintProfiler::getInstance()->getEntries();
+    if (_entries.size() > size_t(maxRows))
+        _entries.resize(size_t(maxRows));
+
+    repaint();
+}
+
+void EvilAudio_PaintProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black);
+
+    g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    auto rows = getLocalBounds().reduced(6, 4);
+
+    const auto drawRow = [&](const juce::String& name, const juce::String& rate, const juce::String& average,
+                             const juce::String& maximum, const juce::String& load)
+    {
+        auto row = rows.removeFromTop(rowHeight);
+        g.drawText(name, row.removeFromLeft(200), juce::Justification::centredLeft, true);
+        for (const auto* column : { &rate, &average, &maximum, &load })
+            g.drawText(*column, row.removeFromLeft(55), juce::Justification::centredRight, false);
+    };
+
+    g.setColour(juce::Colours::silver);
+    drawRow("component", "per s", "avg ms", "max ms", "load %");
+
+    for (const auto& entry : _entries)
+    {
+        // Anything taking more than a tenth of the message thread stands out.
+        g.setColour(entry.paintLoad > 0.1 ? juce::Colours::orangered : juce::Colours::white);
+        drawRow(entry.name,
+                juce::String(entry.paintsPerSecond, 1),
+                juce::String(entry.paints > 0 ? entry.paintSeconds * 1000.0 / entry.paints : 0.0, 2),
+                juce::String(entry.maxPaintSeconds * 1000.0, 2),
+                juce::String(entry.paintLoad * 100.0, 1));
+    }
+}
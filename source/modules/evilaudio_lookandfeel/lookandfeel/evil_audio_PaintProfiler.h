@@ -0,0 +1,132 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+/**
+ *  Records how long components take to paint and lay out, and how often they repaint.
+ *
+ *  Components opt in by putting EVILAUDIO_PROFILE_PAINT(*this) at the top of paint() and
+ *  EVILAUDIO_PROFILE_LAYOUT(*this) at the top of resized(). Both macros compile to nothing
+ *  unless EVILAUDIO_PAINT_PROFILING is set, so instrumented components cost nothing in a
+ *  normal build. The figures can be shown live with EvilAudio_PaintProfilerOverlay or
+ *  written out with createReport(). Message thread only.
+ */
+class EvilAudio_PaintProfiler : private juce::DeletedAtShutdown
+{
+public:
+    enum class Kind
+    {
+        paint,
+        layout
+    };
+
+    /** Totals for one component, named after its name or, failing that, its class. */
+    struct Entry
+    {
+        juce::String name;
+        int paints = 0;
+        int layouts = 0;
+        double paintSeconds = 0.0;
+        double layoutSeconds = 0.0;
+        double maxPaintSeconds = 0.0;
+        /** Paints per second over the last complete second. */
+        double paintsPerSecond = 0.0;
+        /** Seconds spent painting per second of wall time, over the last complete second. */
+        double paintLoad = 0.0;
+
+        double windowStart = 0.0;
+        int windowPaints = 0;
+        double windowSeconds = 0.0;
+        const std::type_info* type = nullptr;
+    };
+
+    /** Times the enclosing scope and records it against a component. */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(const juce::Component& component, Kind kind) noexcept;
+        ~ScopedTimer();
+
+    private:
+        const juce::Component& _component;
+        const Kind _kind;
+        const juce::int64 _start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+
+    EvilAudio_PaintProfiler() = default;
+    ~EvilAudio_PaintProfiler() override;
+
+    void record(const juce::Component& component, Kind kind, double seconds);
+
+    /** Returns every component recorded so far, the busiest painter first. */
+    std::vector<Entry> getEntries() const;
+    /** Returns a table of getEntries(), one line per component. */
+    juce::String createReport() const;
+    /** Writes createReport() to the current logger. */
+    void dumpToLog() const;
+    void reset();
+
+    JUCE_DECLARE_SINGLETON_SINGLETHREADED_MINIMAL(EvilAudio_PaintProfiler)
+
+private:
+    static juce::String getComponentName(const juce::Component& component);
+
+    /**
+     * Components are keyed by address; the entry keeps the name in case it is deleted, and
+     * starts again if the address is reused by a component of another class.
+     */
+    std::unordered_map<const juce::Component*, Entry> _entries;
+};
+
+/**
+ *  A click-through overlay listing the busiest components, refreshed twice a second.
+ *
+ *  Add it on top of a window's content and place it with setTopLeftPosition(); it sizes
+ *  itself to its table. When it is deleted the final figures are written to the log.
+ *
+ *  The overlay is opaque, so its own refreshes repaint only itself: JUCE leaves out
+ *  whatever lies under an opaque component. The area it covers is clipped out of the
+ *  components below, so their paints cost slightly less than they would without it, and
+ *  its own paints aren't timed but still take a little of the message thread's time.
+ *
+ *  Only the outermost overlay in a window is shown. A component that brings its own, such
+ *  as an editor, can be embedded in a window that has one; the inner overlay then hides
+ *  itself and writes nothing to the log.
+ */
+class EvilAudio_PaintProfilerOverlay : public juce::Component,
+                                       private juce::Timer
+{
+public:
+    EvilAudio_PaintProfilerOverlay();
+    ~EvilAudio_PaintProfilerOverlay() override;
+
+    void paint(juce::Graphics& g) override;
+    void parentHierarchyChanged() override;
+
+    /** Number of components listed. */
+    static constexpr int maxRows = 12;
+
+private:
+    void timerCallback() override;
+    /** Shows the overlay only if no ancestor holds another one. */
+    void updateOutermost();
+
+    static constexpr int rowHeight = 14;
+
+    std::vector<EvilAudio_PaintProfiler::Entry> _entries;
+    bool _isOutermost = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EvilAudio_PaintProfilerOverlay)
+};
+
+#if EVILAUDIO_PAINT_PROFILING
+ #define EVILAUDIO_PROFILE_PAINT(component) \
+    const EvilAudio_PaintProfiler::ScopedTimer JUCE_JOIN_MACRO(paintProfilerTimer, __LINE__)(component, EvilAudio_PaintProfiler::Kind::paint)
+ #define EVILAUDIO_PROFILE_LAYOUT(component) \
+    const EvilAudio_PaintProfiler::ScopedTimer JUCE_JOIN_MACRO(paintProfilerTimer, __LINE__)(component, EvilAudio_PaintProfiler::Kind::layout)
+#else
+ #define EVILAUDIO_PROFILE_PAINT(component)
+ #define EVILAUDIO_PROFILE_LAYOUT(component)
+#endif